@@ -79,6 +79,8 @@ if ((WIN32 AND NOT(MINGW OR CYGWIN)) OR NOT LLVM_CONFIG)
             list(REMOVE_ITEM LLVM_FIND_COMPONENTS "debuginfodwarf" index)
             list(REMOVE_ITEM LLVM_FIND_COMPONENTS "debuginfopdb" index)
             list(APPEND LLVM_FIND_COMPONENTS "debuginfo")
+            # ... and component orcjit isn't available either
+            list(REMOVE_ITEM LLVM_FIND_COMPONENTS "orcjit" index)
         endif()
         if(${LLVM_VERSION_STRING} MATCHES "^3\\.[0-8][\\.0-9A-Za-z]*")
             # Versions below 3.9 do not support components debuginfocodeview, globalisel
@@ -164,6 +166,8 @@ else()
         list(REMOVE_ITEM LLVM_FIND_COMPONENTS "debuginfodwarf" index)
         list(REMOVE_ITEM LLVM_FIND_COMPONENTS "debuginfopdb" index)
         list(APPEND LLVM_FIND_COMPONENTS "debuginfo")
+        # ... and component orcjit isn't available either
+        list(REMOVE_ITEM LLVM_FIND_COMPONENTS "orcjit" index)
     endif()
     if(${LLVM_VERSION_STRING} MATCHES "^3\\.[0-8][\\.0-9A-Za-z]*")
         # Versions below 3.9 do not support components debuginfocodeview, globalisel
@@ -26,6 +26,7 @@ class LabelDsymbol;
 class Initializer;
 class Module;
 class ForeachStatement;
+class ExpStatement;
 class FuncDeclaration;
 class ExpInitializer;
 class StructDeclaration;
@@ -548,6 +549,11 @@ public:
     // Whether to emit instrumentation code if -fprofile-instr-generate is specified,
     // the value is set with pragma(LDC_profile_instr, true|false)
     bool emitInstrumentation;
+
+    // For compiler-generated array operations: the per-element statement
+    // of the loop body, e.g., `p0[p] = cast(T)(p1[p] * c2)`. Used by the
+    // backend to lower the array operation inline.
+    ExpStatement *arrayOpLoopBody;
 #endif
 
     Identifier *outId;                  // identifier for out statement
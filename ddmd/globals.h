@@ -217,6 +217,9 @@ struct Param
     bool disableRedZone;
 
     uint32_t hashThreshold; // MD5 hash symbols larger than this threshold (0 = no hashing)
+
+    bool ctfeBytecode;  // evaluate supported functions with the CTFE bytecode interpreter
+    bool vctfeStats;    // print the time and memory spent on CTFE per function
 #endif
 };
 
@@ -55,6 +55,11 @@ cl::list<std::string> runargs(
         "Runs the resulting program, passing the remaining arguments to it"),
     cl::Positional, cl::PositionalEatsArgs);
 
+cl::opt<bool> jit("jit",
+                  cl::desc("With -run, execute the program in-process using "
+                           "the JIT instead of writing and linking objects"),
+                  cl::ZeroOrMore);
+
 static cl::opt<ubyte, true> useDeprecated(
     cl::desc("Allow deprecated code/language features:"), cl::ZeroOrMore,
     cl::values(clEnumValN(0, "de", "Do not allow deprecated features"),
@@ -88,6 +93,17 @@ static cl::opt<bool, true>
     vgc("vgc", cl::desc("list all gc allocations including hidden ones"),
         cl::ZeroOrMore, cl::location(global.params.vgc));
 
+static cl::opt<bool, true>
+    vctfeStats("vctfe-stats",
+               cl::desc("print the time and memory spent on CTFE per function"),
+               cl::ZeroOrMore, cl::location(global.params.vctfeStats));
+
+static cl::opt<bool, true> ctfeBytecode(
+    "ctfe-bytecode",
+    cl::desc("Evaluate supported functions at compile time with the "
+             "experimental bytecode interpreter"),
+    cl::ZeroOrMore, cl::location(global.params.ctfeBytecode));
+
 static cl::opt<bool, true> verbose_cg("v-cg", cl::desc("Verbose codegen"),
                                       cl::ZeroOrMore,
                                       cl::location(global.params.verbose_cg));
@@ -254,6 +270,19 @@ cl::opt<std::string>
     moduleDepsFile("deps", cl::desc("Write module dependencies to filename"),
                    cl::value_desc("filename"));
 
+cl::opt<std::string> layoutReport(
+    "vlayout",
+    cl::desc("Print the layout of each aggregate of the compiled modules, "
+             "incl. padding, cache line splits and a smaller field order "
+             "(=json: one JSON object per aggregate)"),
+    cl::value_desc("json"), cl::ValueOptional);
+
+cl::opt<std::string> interfaceHashFile(
+    "interface-hash",
+    cl::desc("Write a hash of the interface of each compiled module to "
+             "filename"),
+    cl::value_desc("filename"));
+
 cl::opt<std::string> mArch("march",
                            cl::desc("Architecture to generate code for:"));
 
@@ -381,7 +410,8 @@ cl::opt<bool, true>
 
 cl::opt<uint32_t, true> hashThreshold(
     "hash-threshold",
-    cl::desc("hash symbol names longer than this threshold (experimental)"),
+    cl::desc("Hash symbol names longer than this threshold (except for "
+             "druntime/Phobos symbols)"),
     cl::location(global.params.hashThreshold), cl::init(0));
 
 cl::opt<bool> linkonceTemplates(
@@ -390,11 +420,31 @@ cl::opt<bool> linkonceTemplates(
         "Use linkonce_odr linkage for template symbols instead of weak_odr"),
     cl::ZeroOrMore);
 
+cl::opt<bool> dedupTemplateInstances(
+    "dedup-template-instances",
+    cl::desc("When emitting multiple object files, define each template "
+             "instance function in only one of them (the objects must then "
+             "always be linked together)"),
+    cl::ZeroOrMore);
+
+cl::opt<bool> lazyTypeInfo(
+    "lazy-typeinfo",
+    cl::desc("Only emit TypeInfo into the object files actually referencing "
+             "it, to be removed by linker dead stripping otherwise"),
+    cl::ZeroOrMore);
+
 cl::opt<bool> disableLinkerStripDead(
     "disable-linker-strip-dead",
     cl::desc("Do not try to remove unused symbols during linking"),
     cl::init(false));
 
+cl::opt<bool> strictAliasing(
+    "fstrict-aliasing",
+    cl::desc("Emit type-based alias analysis metadata, assuming that memory "
+             "is not accessed via pointers to unrelated types (except in "
+             "explicitly @system functions)"),
+    cl::init(false));
+
 cl::opt<bool, true>
     allinst("allinst",
             cl::desc("generate code for all template instantiations"),
@@ -439,6 +489,13 @@ cl::opt<std::string> usefileInstrProf(
     "fprofile-instr-use", cl::value_desc("filename"),
     cl::desc("Use instrumentation data for profile-guided optimization"),
     cl::ValueRequired);
+
+cl::opt<std::string> symbolOrderingFile(
+    "fprofile-symbol-order", cl::value_desc("filename"),
+    cl::desc("Write a linker symbol ordering file listing the profiled "
+             "functions by decreasing execution count (requires "
+             "-fprofile-instr-use)"),
+    cl::ValueRequired);
 #endif
 
 static cl::extrahelp footer(
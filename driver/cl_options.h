@@ -34,6 +34,7 @@ namespace cl = llvm::cl;
  */
 extern cl::list<std::string> fileList;
 extern cl::list<std::string> runargs;
+extern cl::opt<bool> jit;
 extern cl::opt<bool> compileOnly;
 extern cl::opt<bool, true> enforcePropertySyntax;
 extern cl::opt<bool> createStaticLib;
@@ -56,6 +57,8 @@ extern cl::opt<std::string> hdrFile;
 extern cl::list<std::string> versions;
 extern cl::list<std::string> transitions;
 extern cl::opt<std::string> moduleDepsFile;
+extern cl::opt<std::string> interfaceHashFile;
+extern cl::opt<std::string> layoutReport;
 extern cl::opt<std::string> ir2objCacheDir;
 
 extern cl::opt<std::string> mArch;
@@ -73,7 +76,10 @@ extern cl::opt<bool> disableFpElim;
 extern cl::opt<FloatABI::Type> mFloatABI;
 extern cl::opt<bool, true> singleObj;
 extern cl::opt<bool> linkonceTemplates;
+extern cl::opt<bool> dedupTemplateInstances;
+extern cl::opt<bool> lazyTypeInfo;
 extern cl::opt<bool> disableLinkerStripDead;
+extern cl::opt<bool> strictAliasing;
 
 extern cl::opt<BOUNDSCHECK> boundsCheck;
 extern bool nonSafeBoundsChecks;
@@ -83,6 +89,7 @@ extern cl::opt<unsigned, true> nestedTemplateDepth;
 #if LDC_WITH_PGO
 extern cl::opt<std::string> genfileInstrProf;
 extern cl::opt<std::string> usefileInstrProf;
+extern cl::opt<std::string> symbolOrderingFile;
 #endif
 
 // Arguments to -d-debug
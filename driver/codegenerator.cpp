@@ -13,9 +13,13 @@
 #include "mars.h"
 #include "module.h"
 #include "scope.h"
+#include "driver/cl_options.h"
+#include "driver/jit.h"
 #include "driver/linker.h"
 #include "driver/toobj.h"
 #include "gen/logger.h"
+#include "gen/mangling.h"
+#include "gen/optimizer.h"
 #include "gen/runtime.h"
 
 void codegenModule(IRState *irs, Module *m, bool emitFullModuleInfo);
@@ -176,8 +180,16 @@ void CodeGenerator::writeAndFreeLLModule(const char *filename) {
       {llvm::MDString::get(ir_->context(), Version)};
   IdentMetadata->addOperand(llvm::MDNode::get(ir_->context(), IdentNode));
 
-  writeModule(&ir_->module, filename);
-  global.params.objfiles->push(const_cast<char *>(filename));
+  writeHashedSymbolMap(*ir_, filename);
+
+  if (opts::jit) {
+    // Compile the optimized module to memory for in-process execution.
+    ldc_optimize_module(&ir_->module);
+    addJITModule(ir_->module);
+  } else {
+    writeModule(&ir_->module, filename);
+    global.params.objfiles->push(const_cast<char *>(filename));
+  }
   delete ir_;
   ir_ = nullptr;
 }
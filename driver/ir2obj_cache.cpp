@@ -38,6 +38,7 @@
 #include "llvm/Bitcode/ReaderWriter.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -105,6 +106,16 @@ void calculateModuleHash(llvm::Module *m, llvm::SmallString<32> &str) {
   hash_os << opts::mCodeModel;
   hash_os << opts::disableFpElim;
 
+  // The sample profile isn't part of the IR, it's only read by the optimizer.
+  if (!opts::usefileSampleProf.empty()) {
+    auto profile = llvm::MemoryBuffer::getFile(opts::usefileSampleProf);
+    if (profile) {
+      hash_os << (*profile)->getBuffer();
+    } else {
+      hash_os << opts::usefileSampleProf;
+    }
+  }
+
   llvm::WriteBitcodeToFile(m, hash_os);
   hash_os.resultAsString(str);
   IF_LOG Logger::println("Module's LLVM bitcode hash is: %s", str.c_str());
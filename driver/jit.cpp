@@ -0,0 +1,458 @@
+//===-- jit.cpp -----------------------------------------------------------===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "driver/jit.h"
+
+#include "errors.h"
+#include "globals.h"
+#include "driver/cl_options.h"
+#include "gen/irstate.h"
+#include "gen/logger.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#if LDC_LLVM_VER >= 400
+#include "llvm/ExecutionEngine/JITSymbol.h"
+#include "llvm/ExecutionEngine/RTDyldMemoryManager.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/LambdaResolver.h"
+#include "llvm/ExecutionEngine/Orc/ObjectLinkingLayer.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Mangler.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/MathExtras.h"
+#endif
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+#if LDC_LLVM_VER >= 400
+typedef llvm::object::OwningBinary<llvm::object::ObjectFile> JITObject;
+
+std::vector<std::unique_ptr<JITObject>> jitObjects;
+
+/// An entry of llvm.global_ctors/llvm.global_dtors of a JIT-compiled module.
+struct JITCtorDtor {
+  unsigned priority;
+  std::string name; // mangled
+};
+
+std::vector<JITCtorDtor> jitCtors;
+std::vector<JITCtorDtor> jitDtors;
+
+/// The shared libraries loaded for the JIT-compiled code, in the order of the
+/// command line.
+std::vector<llvm::sys::DynamicLibrary> jitLibs;
+
+/// On ELF platforms, druntime registers the ModuleInfos of a DSO with
+/// _d_dso_registry(), which locates the DSO by the address of its slot
+/// (ldc.dso_slot) via dl_iterate_phdr() and adds the DSO's writable segments
+/// to the GC roots. Memory mapped by the JIT isn't part of any loaded DSO, so
+/// the writable data sections of the JIT-compiled code are placed in this
+/// zero-initialized array in the .bss section of the compiler executable
+/// instead. druntime then sees the compiler as the DSO of the program, and
+/// scans its data segment, including the program's data.
+const size_t jitDataArenaSize = 16 * 1024 * 1024;
+alignas(64) char jitDataArena[jitDataArenaSize];
+size_t jitDataArenaUsed = 0;
+
+class JITMemoryManager : public llvm::SectionMemoryManager {
+public:
+  uint8_t *allocateDataSection(uintptr_t size, unsigned alignment,
+                               unsigned sectionID,
+                               llvm::StringRef sectionName,
+                               bool isReadOnly) override {
+    // Read-only data can't contain references to the GC heap.
+    if (isReadOnly) {
+      return SectionMemoryManager::allocateDataSection(
+          size, alignment, sectionID, sectionName, isReadOnly);
+    }
+
+    const uintptr_t arenaStart = reinterpret_cast<uintptr_t>(jitDataArena);
+    const uintptr_t start = llvm::alignTo(arenaStart + jitDataArenaUsed,
+                                          std::max(alignment, 16u));
+    if (start + size > arenaStart + jitDataArenaSize) {
+      error(Loc(), "the writable data of the program exceeds the %u MiB "
+                   "supported by -jit",
+            static_cast<unsigned>(jitDataArenaSize / (1024 * 1024)));
+      fatal();
+    }
+    jitDataArenaUsed = start + size - arenaStart;
+    return reinterpret_cast<uint8_t *>(start);
+  }
+};
+
+/// The thread-local variables of the JIT-compiled code are emulated (there is
+/// no TLS segment to put them in). This mirrors the control variable
+/// (__emutls_v.<name>) emitted by LLVM for each of them.
+struct EmuTLSControl {
+  size_t size;
+  size_t align;
+  union {
+    uintptr_t index;
+    void *address;
+  } object;
+  void *value; // the initializer, or null for zero-initialization
+};
+
+std::mutex emuTLSMutex;
+uintptr_t emuTLSNumVariables = 0;
+thread_local std::vector<void *> emuTLSInstances;
+
+typedef void (*GCAddRangeFn)(const void *, size_t, const void *);
+GCAddRangeFn gcAddRange = nullptr;
+
+/// Replaces __emutls_get_address(), returning the calling thread's instance of
+/// an emulated TLS variable. The instances are allocated on first access and,
+/// like the TLS segment of a DSO, added to the GC roots. They are never freed,
+/// as the GC may still scan them after their thread has exited.
+void *emuTLSGetAddress(EmuTLSControl *control) {
+  auto &atomicIndex =
+      *reinterpret_cast<std::atomic<uintptr_t> *>(&control->object.index);
+  uintptr_t index = atomicIndex.load(std::memory_order_acquire);
+  if (!index) {
+    std::lock_guard<std::mutex> lock(emuTLSMutex);
+    index = atomicIndex.load(std::memory_order_relaxed);
+    if (!index) {
+      index = ++emuTLSNumVariables;
+      atomicIndex.store(index, std::memory_order_release);
+    }
+  }
+
+  if (index > emuTLSInstances.size()) {
+    emuTLSInstances.resize(index, nullptr);
+  }
+  void *&instance = emuTLSInstances[index - 1];
+  if (!instance) {
+    const size_t align = std::max(control->align, sizeof(void *));
+    void *memory = malloc(control->size + align - 1);
+    if (!memory) {
+      fprintf(stderr, "Out of memory allocating thread-local storage\n");
+      abort();
+    }
+    instance = reinterpret_cast<void *>(
+        llvm::alignTo(reinterpret_cast<uintptr_t>(memory), align));
+    if (control->value) {
+      memcpy(instance, control->value, control->size);
+    } else {
+      memset(instance, 0, control->size);
+    }
+    if (gcAddRange) {
+      gcAddRange(instance, control->size, nullptr);
+    }
+  }
+  return instance;
+}
+
+/// The .minfo_beg/.minfo_end symbols bracketing the ModuleInfo references in
+/// the .minfo section (see build_dso_registry_calls() in gen/module.cpp) rely
+/// on the static linker laying out these sections contiguously, which the JIT
+/// doesn't do. Instead, gather all references in an explicit array and pass
+/// its bounds to _d_dso_registry().
+void buildExplicitModuleInfoRecord(llvm::Module &m) {
+  std::vector<llvm::GlobalVariable *> begSymbols;
+  std::vector<llvm::GlobalVariable *> endSymbols;
+  std::vector<llvm::Constant *> moduleRefs;
+  for (auto &gv : m.globals()) {
+    if (!gv.hasSection()) {
+      continue;
+    }
+    const llvm::StringRef section = gv.getSection();
+    if (section == ".minfo_beg") {
+      begSymbols.push_back(&gv);
+    } else if (section == ".minfo_end") {
+      endSymbols.push_back(&gv);
+    } else if (section == ".minfo") {
+      moduleRefs.push_back(gv.getInitializer());
+    }
+  }
+  if (moduleRefs.empty()) {
+    return;
+  }
+
+  auto arrayType =
+      llvm::ArrayType::get(moduleRefs[0]->getType(), moduleRefs.size());
+  auto moduleRefArray = new llvm::GlobalVariable(
+      m, arrayType, false, llvm::GlobalValue::InternalLinkage,
+      llvm::ConstantArray::get(arrayType, moduleRefs), "ldc.jit_minfo");
+
+  auto replaceWithElementAddress = [&](llvm::GlobalVariable *gv,
+                                       uint64_t index) {
+    llvm::Constant *indices[] = {
+        llvm::ConstantInt::get(llvm::Type::getInt32Ty(m.getContext()), 0),
+        llvm::ConstantInt::get(llvm::Type::getInt32Ty(m.getContext()), index)};
+    auto address = llvm::ConstantExpr::getInBoundsGetElementPtr(
+        arrayType, moduleRefArray, indices);
+    gv->replaceAllUsesWith(
+        llvm::ConstantExpr::getPointerCast(address, gv->getType()));
+    gv->eraseFromParent();
+  };
+  for (auto gv : begSymbols) {
+    replaceWithElementAddress(gv, 0);
+  }
+  for (auto gv : endSymbols) {
+    replaceWithElementAddress(gv, moduleRefs.size());
+  }
+}
+
+std::string getSharedLibFileName(llvm::StringRef name) {
+  const llvm::Triple &triple = *global.params.targetTriple;
+  if (triple.isOSWindows()) {
+    return (name + ".dll").str();
+  }
+  if (triple.isOSDarwin()) {
+    return ("lib" + name + ".dylib").str();
+  }
+  return ("lib" + name + ".so").str();
+}
+
+bool loadSharedLib(const std::string &path) {
+  std::string errorMessage;
+  auto lib = llvm::sys::DynamicLibrary::getPermanentLibrary(path.c_str(),
+                                                            &errorMessage);
+  if (!lib.isValid()) {
+    IF_LOG Logger::println("Cannot load '%s': %s", path.c_str(),
+                           errorMessage.c_str());
+    return false;
+  }
+  jitLibs.push_back(lib);
+  if (global.params.verbose) {
+    fprintf(global.stdmsg, "jit load  %s\n", path.c_str());
+  }
+  return true;
+}
+
+/// Loads the shared libraries corresponding to the -l switches (including the
+/// default libraries) and the shared library files on the command line, so
+/// that the JIT-compiled code can be resolved against them in-process.
+/// Static libraries can't be loaded; for a library `foo`, the LDC naming
+/// convention for shared builds of druntime/Phobos, `foo-shared`, is tried
+/// too. Libraries which can't be found are skipped, as their symbols are
+/// usually part of the compiler process already (libc, libm, libpthread, ...).
+void loadSharedLibs() {
+  std::vector<llvm::StringRef> searchDirs;
+  std::vector<llvm::StringRef> libNames;
+  for (auto s : *global.params.linkswitches) {
+    llvm::StringRef sw(s);
+    if (sw.startswith("-L")) {
+      searchDirs.push_back(sw.substr(2));
+    } else if (sw.startswith("-l")) {
+      libNames.push_back(sw.substr(2));
+    }
+  }
+
+  for (auto name : libNames) {
+    bool loaded = false;
+    for (const auto &libName : {name.str(), (name + "-shared").str()}) {
+      const std::string fileName = getSharedLibFileName(libName);
+      for (auto dir : searchDirs) {
+        llvm::SmallString<128> path(dir);
+        llvm::sys::path::append(path, fileName);
+        if (llvm::sys::fs::exists(path.str()) && loadSharedLib(path.str())) {
+          loaded = true;
+          break;
+        }
+      }
+      // Fall back to the default search paths of the dynamic loader.
+      if (!loaded) {
+        loaded = loadSharedLib(fileName);
+      }
+      if (loaded) {
+        break;
+      }
+    }
+    if (!loaded) {
+      IF_LOG Logger::println("No shared library found for -l%s",
+                             name.str().c_str());
+    }
+  }
+
+  for (auto f : *global.params.libfiles) {
+    llvm::StringRef ext = llvm::sys::path::extension(f);
+    if (ext == ".so" || ext == ".dylib" || ext == ".dll") {
+      loadSharedLib(f);
+    }
+  }
+
+  // Make the symbols of the compiler process itself available as a fallback.
+  llvm::sys::DynamicLibrary::LoadLibraryPermanently(nullptr);
+}
+
+/// Returns the address of the (unmangled) symbol `name` in the explicitly
+/// loaded shared libraries, or null. These have to be searched before the
+/// compiler process, which links its own copy of druntime statically; the
+/// program must not bind rt_init(), _d_dso_registry(), gc_*() etc. to that.
+void *findSymbolInLibs(const std::string &name) {
+  for (auto &lib : jitLibs) {
+    if (void *addr = lib.getAddressOfSymbol(name.c_str())) {
+      return addr;
+    }
+  }
+  return nullptr;
+}
+
+std::string getMangledName(llvm::StringRef name) {
+  std::string mangled;
+  llvm::raw_string_ostream os(mangled);
+  llvm::Mangler::getNameWithPrefix(os, name, *gDataLayout);
+  return os.str();
+}
+#endif
+}
+
+void addJITModule(llvm::Module &module) {
+#if LDC_LLVM_VER >= 400
+  IF_LOG Logger::println("Compiling module %s for the JIT",
+                         module.getModuleIdentifier().c_str());
+  LOG_SCOPE
+
+  buildExplicitModuleInfoRecord(module);
+
+  for (auto ctor : llvm::orc::getConstructors(module)) {
+    if (ctor.Func) {
+      jitCtors.push_back(
+          {ctor.Priority, getMangledName(ctor.Func->getName())});
+    }
+  }
+  for (auto dtor : llvm::orc::getDestructors(module)) {
+    if (dtor.Func) {
+      jitDtors.push_back(
+          {dtor.Priority, getMangledName(dtor.Func->getName())});
+    }
+  }
+
+  auto object = llvm::make_unique<JITObject>(
+      llvm::orc::SimpleCompiler(*gTargetMachine)(module));
+  if (!object->getBinary()) {
+    error(Loc(), "cannot compile module %s with -jit",
+          module.getModuleIdentifier().c_str());
+    return;
+  }
+  jitObjects.push_back(std::move(object));
+#endif
+}
+
+int runJIT(const char *programName) {
+#if LDC_LLVM_VER >= 400
+  using namespace llvm;
+  using namespace llvm::orc;
+
+  IF_LOG Logger::println("Executing %llu objects with the JIT",
+                         static_cast<unsigned long long>(jitObjects.size()));
+  LOG_SCOPE
+
+  loadSharedLibs();
+
+  gcAddRange = reinterpret_cast<GCAddRangeFn>(findSymbolInLibs("gc_addRange"));
+  if (!gcAddRange) {
+    gcAddRange = reinterpret_cast<GCAddRangeFn>(
+        llvm::sys::DynamicLibrary::SearchForAddressOfSymbol("gc_addRange"));
+  }
+
+  ObjectLinkingLayer<> objectLayer;
+
+  // Symbols are looked up in the JIT-compiled objects first, then in the
+  // loaded shared libraries, and only then in the process (for libc etc.).
+  const std::string emuTLSGetAddressName =
+      getMangledName("__emutls_get_address");
+  const char globalPrefix = gDataLayout->getGlobalPrefix();
+  auto resolver = createLambdaResolver(
+      [&objectLayer](const std::string &name) {
+        if (auto sym = objectLayer.findSymbol(name, false)) {
+          return sym;
+        }
+        return JITSymbol(nullptr);
+      },
+      [&emuTLSGetAddressName, globalPrefix](const std::string &name) {
+        if (name == emuTLSGetAddressName) {
+          return JITSymbol(reinterpret_cast<uintptr_t>(&emuTLSGetAddress),
+                           JITSymbolFlags::Exported);
+        }
+        const bool hasPrefix =
+            globalPrefix && !name.empty() && name[0] == globalPrefix;
+        if (void *addr = findSymbolInLibs(hasPrefix ? name.substr(1) : name)) {
+          return JITSymbol(reinterpret_cast<uintptr_t>(addr),
+                           JITSymbolFlags::Exported);
+        }
+        if (auto addr = RTDyldMemoryManager::getSymbolAddressInProcess(name)) {
+          return JITSymbol(addr, JITSymbolFlags::Exported);
+        }
+        return JITSymbol(nullptr);
+      });
+
+  auto handle = objectLayer.addObjectSet(std::move(jitObjects),
+                                         llvm::make_unique<JITMemoryManager>(),
+                                         std::move(resolver));
+  jitObjects.clear();
+
+  auto mainSym =
+      objectLayer.findSymbolIn(handle, getMangledName("main"), false);
+  if (!mainSym) {
+    error(Loc(), "no main function to run with -jit");
+    return EXIT_FAILURE;
+  }
+
+  // Like the static constructors and destructors of a loaded DSO, both are
+  // run in ascending order of priority, and in the order of the modules and
+  // of llvm.global_ctors/llvm.global_dtors for equal priorities.
+  typedef void (*CtorDtorFn)();
+  auto runCtorsDtors = [&](std::vector<JITCtorDtor> &entries) {
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const JITCtorDtor &a, const JITCtorDtor &b) {
+                       return a.priority < b.priority;
+                     });
+    for (const auto &entry : entries) {
+      if (auto sym = objectLayer.findSymbolIn(handle, entry.name, false)) {
+        reinterpret_cast<CtorDtorFn>(
+            static_cast<uintptr_t>(sym.getAddress()))();
+      }
+    }
+  };
+
+  // Register the D modules with druntime etc.
+  runCtorsDtors(jitCtors);
+
+  std::vector<char *> argv;
+  argv.push_back(const_cast<char *>(programName));
+  for (auto &arg : opts::runargs) {
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  typedef int (*MainFn)(int, char **);
+  auto mainFn =
+      reinterpret_cast<MainFn>(static_cast<uintptr_t>(mainSym.getAddress()));
+
+  fflush(stdout);
+  fflush(stderr);
+  const int status = mainFn(static_cast<int>(argv.size() - 1), argv.data());
+
+  runCtorsDtors(jitDtors);
+
+  return status;
+#else
+  error(Loc(), "-jit requires LDC to be built against LLVM 4.0 or later");
+  return EXIT_FAILURE;
+#endif
+}
@@ -0,0 +1,36 @@
+//===-- driver/jit.h - In-process execution for -run ------------*- C++ -*-===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Executes the generated modules in-process with LLVM's ORC JIT (-run -jit),
+// avoiding object files and the linker.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LDC_DRIVER_JIT_H
+#define LDC_DRIVER_JIT_H
+
+namespace llvm {
+class Module;
+}
+
+/**
+ * Compiles a fully generated module to an in-memory object, to be executed by
+ * runJIT().
+ */
+void addJITModule(llvm::Module &module);
+
+/**
+ * Loads the objects compiled by addJITModule() in-process, resolving external
+ * symbols in the shared versions of the libraries to be linked with, runs the
+ * module constructors and calls the C main() with the -run arguments.
+ * @return the exit status of the program.
+ */
+int runJIT(const char *programName);
+
+#endif // LDC_DRIVER_JIT_H
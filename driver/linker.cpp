@@ -575,15 +575,18 @@ static int linkObjToBinaryWin(bool sharedLib) {
     args.push_back("/SAFESEH");
   }
 
+  // Debug info only used for optimization remarks isn't emitted.
+  const bool symdebug = global.params.symdebug && !opts::debugLocationsOnly;
+
   // because of a LLVM bug, see LDC issue 442
-  if (global.params.symdebug) {
+  if (symdebug) {
     args.push_back("/LARGEADDRESSAWARE:NO");
   } else {
     args.push_back("/LARGEADDRESSAWARE");
   }
 
   // output debug information
-  if (global.params.symdebug) {
+  if (symdebug) {
     args.push_back("/DEBUG");
   }
 
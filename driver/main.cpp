@@ -23,11 +23,14 @@
 #include "driver/codegenerator.h"
 #include "driver/configfile.h"
 #include "driver/exe_path.h"
+#include "driver/jit.h"
 #include "driver/ldc-version.h"
 #include "driver/linker.h"
 #include "driver/targetmachine.h"
+#include "driver/toobj.h"
 #include "gen/cl_helpers.h"
 #include "gen/irstate.h"
+#include "gen/layoutreport.h"
 #include "gen/linkage.h"
 #include "gen/llvm.h"
 #include "gen/llvmhelpers.h"
@@ -76,9 +79,15 @@ int rt_init();
 // In ddmd/doc.d
 void gendocfile(Module *m);
 
+// In ddmd/dinterpret.d
+void printCtfePerformanceStats();
+
 // In driver/main.d
 void writeModuleDependencyFile();
 
+// In driver/interfacehash.d
+void writeInterfaceHashFile(const char *filename, Modules *modules);
+
 using namespace opts;
 
 extern void getenv_setargv(const char *envvar, int *pargc, char ***pargv);
@@ -478,6 +487,11 @@ static void parseCommandLine(int argc, char **argv, Strings &sourceFiles,
     global.params.moduleDeps = new OutBuffer;
   }
 
+  if (!opts::layoutReport.empty() && opts::layoutReport != "json") {
+    error(Loc(), "unknown -vlayout format '%s', expected 'json'",
+          opts::layoutReport.c_str());
+  }
+
 // PGO options
 #if LDC_WITH_PGO
   if (genfileInstrProf.getNumOccurrences() > 0) {
@@ -493,11 +507,48 @@ static void parseCommandLine(int argc, char **argv, Strings &sourceFiles,
     // profdata file:
     initFromString(global.params.datafileInstrProf, usefileInstrProf);
   }
+  if (!symbolOrderingFile.empty() && usefileInstrProf.empty()) {
+    error(Loc(), "-fprofile-symbol-order requires -fprofile-instr-use");
+  }
 #else
   global.params.datafileInstrProf = nullptr;
   global.params.genInstrProf = false;
 #endif
 
+  if (!opts::usefileSampleProf.empty()) {
+    if (global.params.genInstrProf || global.params.datafileInstrProf) {
+      error(Loc(), "-fprofile-sample-use cannot be combined with "
+                   "-fprofile-instr-generate or -fprofile-instr-use");
+    } else if (!llvm::sys::fs::exists(opts::usefileSampleProf)) {
+      error(Loc(), "sample profile file '%s' not found",
+            opts::usefileSampleProf.c_str());
+    }
+    // The samples are mapped to the code via the debug line info. Don't emit
+    // any debug sections unless requested though.
+    if (!global.params.symdebug) {
+      global.params.symdebug = 1;
+      opts::debugLocationsOnly = true;
+    }
+  }
+
+  if (willEmitOptimizationRemarks()) {
+#if LDC_LLVM_VER < 309
+    error(Loc(), "optimization remarks require LLVM 3.9+");
+#else
+#if LDC_LLVM_VER < 400
+    if (opts::saveOptimizationRecord.getNumOccurrences()) {
+      error(Loc(), "-fsave-optimization-record requires LLVM 4.0+");
+    }
+#endif
+    // The remarks are mapped to the D source via the debug line info. Don't
+    // emit any debug sections unless requested though.
+    if (!global.params.symdebug) {
+      global.params.symdebug = 1;
+      opts::debugLocationsOnly = true;
+    }
+#endif
+  }
+
   processVersions(debugArgs, "debug", DebugCondition::setGlobalLevel,
                   DebugCondition::addGlobalIdent);
   processVersions(versions, "version", VersionCondition::setGlobalLevel,
@@ -543,6 +594,14 @@ static void parseCommandLine(int argc, char **argv, Strings &sourceFiles,
     }
   }
 
+  if (opts::jit) {
+    if (!global.params.run) {
+      error(Loc(), "-jit can only be used with -run");
+    }
+    // The JIT executes a single module, see driver/jit.cpp.
+    global.params.singleObj = true;
+  }
+
   sourceFiles.reserve(fileList.size());
   for (const auto &file : fileList) {
     if (!file.empty()) {
@@ -1103,9 +1162,18 @@ int cppmain(int argc, char **argv) {
     fatal();
   }
 
+  // With -jit, the code and data sections may end up far apart in memory, and
+  // thread-local variables can't be placed in a TLS segment (see
+  // driver/jit.cpp).
   gTargetMachine = createTargetMachine(
       mTargetTriple, mArch, mCPU, mAttrs, bitness, mFloatABI, getRelocModel(),
-      mCodeModel, codeGenOptLevel(), disableFpElim, disableLinkerStripDead);
+      opts::jit ? llvm::CodeModel::Large : mCodeModel, codeGenOptLevel(),
+      disableFpElim, disableLinkerStripDead);
+#if LDC_LLVM_VER >= 400
+  if (opts::jit) {
+    gTargetMachine->Options.EmulatedTLS = true;
+  }
+#endif
 
 #if LDC_LLVM_VER >= 308
   static llvm::DataLayout DL = gTargetMachine->createDataLayout();
@@ -1408,8 +1476,20 @@ int cppmain(int argc, char **argv) {
   // the user requested it.
   writeModuleDependencyFile();
 
+  if (!opts::interfaceHashFile.empty()) {
+    writeInterfaceHashFile(opts::interfaceHashFile.c_str(), &modules);
+  }
+
   // Generate one or more object/IR/bitcode files.
   if (global.params.obj && !modules.empty()) {
+    if (!opts::saveOptimizationRecord.empty() && !singleObj &&
+        modules.dim > 1) {
+      error(Loc(), "-fsave-optimization-record=<file> cannot be used for "
+                   "multiple object files, use -singleobj");
+      fatal();
+    }
+    setupOptimizationRemarks(getGlobalContext());
+
     ldc::CodeGenerator cg(getGlobalContext(), singleObj);
 
     // When inlining is enabled, we are calling semantic3 on function
@@ -1434,6 +1514,12 @@ int cppmain(int argc, char **argv) {
     }
   }
 
+  writeSymbolOrderingFile();
+
+  printCtfePerformanceStats();
+
+  printLayoutReport();
+
   // Generate DDoc output files.
   if (global.params.doDocComments) {
     for (unsigned i = 0; i < modules.dim; i++) {
@@ -1446,6 +1532,15 @@ int cppmain(int argc, char **argv) {
     emitJson(modules);
   }
 
+  // With -jit, execute the program in-process instead of linking it (before
+  // shutting down LLVM).
+  int status = EXIT_SUCCESS;
+  if (opts::jit && !global.errors) {
+    status = runJIT(global.params.exefile
+                        ? global.params.exefile
+                        : FileName::removeExt(modules[0]->srcfile->toChars()));
+  }
+
   freeRuntime();
   llvm::llvm_shutdown();
 
@@ -1453,9 +1548,12 @@ int cppmain(int argc, char **argv) {
     fatal();
   }
 
+  if (opts::jit) {
+    return status;
+  }
+
   // Finally, produce the final executable/archive and run it, if we are
   // supposed to.
-  int status = EXIT_SUCCESS;
   if (!global.params.objfiles->dim) {
     if (global.params.link) {
       error(Loc(), "no object files to link");
@@ -19,6 +19,7 @@
 #include "gen/programs.h"
 #include "llvm/IR/AssemblyAnnotationWriter.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Bitcode/ReaderWriter.h"
 #if LDC_LLVM_VER >= 307
 #include "llvm/IR/LegacyPassManager.h"
@@ -40,8 +41,10 @@
 #include "llvm/Target/TargetSubtargetInfo.h"
 #endif
 #include "llvm/IR/Module.h"
+#include <algorithm>
 #include <cstddef>
 #include <fstream>
+#include <vector>
 
 #if LDC_LLVM_VER >= 306
 using LLErrorInfo = std::error_code;
@@ -363,8 +366,87 @@ void writeObjectFile(llvm::Module *m, std::string &filename) {
     }
   }
 }
+
+#if LDC_WITH_PGO
+/// The profiled functions of all modules emitted so far, with their entry
+/// counts, for -fprofile-symbol-order.
+std::vector<std::pair<uint64_t, std::string>> profiledFunctions;
+
+uint64_t getEntryCount(const llvm::Function *F) {
+  auto count = F->getEntryCount();
+  return count.hasValue() ? count.getValue() : 0;
+}
+
+/// Moves the function definitions with profile data to the front of the
+/// module, ordered by decreasing entry count. Functions are emitted in module
+/// order, so the hottest functions end up next to each other.
+void orderFunctionsByProfileCount(llvm::Module &m) {
+  std::vector<llvm::Function *> profiled;
+  for (auto &F : m) {
+    if (!F.isDeclaration() && F.getEntryCount().hasValue()) {
+      profiled.push_back(&F);
+    }
+  }
+
+  std::stable_sort(profiled.begin(), profiled.end(),
+                   [](const llvm::Function *a, const llvm::Function *b) {
+                     return getEntryCount(a) > getEntryCount(b);
+                   });
+
+  auto &functions = m.getFunctionList();
+  for (auto it = profiled.rbegin(), end = profiled.rend(); it != end; ++it) {
+    (*it)->removeFromParent();
+    functions.push_front(*it);
+  }
+
+  if (!opts::symbolOrderingFile.empty()) {
+    for (auto F : profiled) {
+      uint64_t count = getEntryCount(F);
+      if (count == 0) {
+        break;
+      }
+      // Strip the LLVM "don't mangle" marker (see mangleFunctionForLLVM).
+      profiledFunctions.emplace_back(count, F->getName().ltrim("\1").str());
+    }
+  }
+}
+#endif
 } // end of anonymous namespace
 
+void writeSymbolOrderingFile() {
+#if LDC_WITH_PGO
+  if (opts::symbolOrderingFile.empty()) {
+    return;
+  }
+
+  // Template instances may have been emitted into several objects; list each
+  // symbol once, with its highest count.
+  std::stable_sort(profiledFunctions.begin(), profiledFunctions.end(),
+                   [](const std::pair<uint64_t, std::string> &a,
+                      const std::pair<uint64_t, std::string> &b) {
+                     return a.first > b.first;
+                   });
+
+  IF_LOG Logger::println("Writing symbol ordering file to: %s",
+                         opts::symbolOrderingFile.c_str());
+  LLErrorInfo errinfo;
+  llvm::raw_fd_ostream out(opts::symbolOrderingFile.c_str(), errinfo,
+                           llvm::sys::fs::F_Text);
+  if (out.has_error()) {
+    error(Loc(), "cannot write symbol ordering file '%s': %s",
+          opts::symbolOrderingFile.c_str(), ERRORINFO_STRING(errinfo));
+    fatal();
+  }
+
+  llvm::StringSet<> written;
+  for (const auto &entry : profiledFunctions) {
+    if (written.insert(entry.second).second) {
+      out << entry.second << '\n';
+    }
+  }
+#endif
+}
+
 void writeModule(llvm::Module *m, std::string filename) {
   // There is no integrated assembler on AIX because XCOFF is not supported.
   // Starting with LLVM 3.5 the integrated assembler can be used with MinGW.
@@ -374,7 +456,13 @@ void writeModule(llvm::Module *m, std::string filename) {
        global.params.targetTriple->getOS() == llvm::Triple::AIX);
 
   // Use cached object code if possible
-  bool useIR2ObjCache = !opts::ir2objCacheDir.empty();
+  // (Cached object code doesn't come with any optimization remarks, and its
+  // functions wouldn't be listed in the -fprofile-symbol-order file.)
+  bool useIR2ObjCache =
+      !opts::ir2objCacheDir.empty() && !willEmitOptimizationRemarks();
+#if LDC_WITH_PGO
+  useIR2ObjCache = useIR2ObjCache && opts::symbolOrderingFile.empty();
+#endif
   llvm::SmallString<32> moduleHash;
   if (useIR2ObjCache && global.params.output_o && !assembleExternally) {
     llvm::SmallString<128> cacheDir(opts::ir2objCacheDir.c_str());
@@ -393,9 +481,18 @@ void writeModule(llvm::Module *m, std::string filename) {
     }
   }
 
+  // The remarks are emitted during optimization and code generation.
+  startOptimizationRecord(*m, filename);
+
   // run optimizer
   ldc_optimize_module(m);
 
+#if LDC_WITH_PGO
+  if (global.params.datafileInstrProf && !global.params.genInstrProf) {
+    orderFunctionsByProfileCount(*m);
+  }
+#endif
+
   // eventually do our own path stuff, dmd's is a bit strange.
   using LLPath = llvm::SmallString<128>;
 
@@ -471,6 +568,8 @@ void writeModule(llvm::Module *m, std::string filename) {
       ir2obj::cacheObjectFile(filename, moduleHash);
     }
   }
+
+  finishOptimizationRecord(*m);
 }
 
 #undef ERRORINFO_STRING
@@ -22,4 +22,8 @@ class Module;
 
 void writeModule(llvm::Module *m, std::string filename);
 
+/// Writes the functions of all modules emitted so far, ordered by decreasing
+/// profile count, to the file given by -fprofile-symbol-order (if any).
+void writeSymbolOrderingFile();
+
 #endif
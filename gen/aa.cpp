@@ -42,8 +42,8 @@ DLValue *DtoAAIndex(Loc &loc, Type *type, DValue *aa, DValue *key,
   // extern(C) void* _aaInX(AA aa*, TypeInfo keyti, void* pkey)
 
   // first get the runtime function
-  llvm::Function *func =
-      getRuntimeFunction(loc, gIR->module, lvalue ? "_aaGetY" : "_aaInX");
+  llvm::Function *func = getRuntimeFunction(
+      loc, gIR->module, lvalue ? RTFunc::_aaGetY : RTFunc::_aaInX);
   LLFunctionType *funcTy = func->getFunctionType();
 
   // aa param
@@ -93,7 +93,7 @@ DLValue *DtoAAIndex(Loc &loc, Type *type, DValue *aa, DValue *key,
     gIR->scope() = IRScope(failbb);
 
     llvm::Function *errorfn =
-        getRuntimeFunction(loc, gIR->module, "_d_arraybounds");
+        getRuntimeFunction(loc, gIR->module, RTFunc::_d_arraybounds);
     gIR->CreateCallOrInvoke(
         errorfn, DtoModuleFileName(gIR->func()->decl->getModule(), loc),
         DtoConstUint(loc.linnum));
@@ -119,7 +119,7 @@ DValue *DtoAAIn(Loc &loc, Type *type, DValue *aa, DValue *key) {
   // extern(C) void* _aaInX(AA aa*, TypeInfo keyti, void* pkey)
 
   // first get the runtime function
-  llvm::Function *func = getRuntimeFunction(loc, gIR->module, "_aaInX");
+  llvm::Function *func = getRuntimeFunction(loc, gIR->module, RTFunc::_aaInX);
   LLFunctionType *funcTy = func->getFunctionType();
 
   IF_LOG Logger::cout() << "_aaIn = " << *func << '\n';
@@ -165,7 +165,7 @@ DValue *DtoAARemove(Loc &loc, DValue *aa, DValue *key) {
   // extern(C) bool _aaDelX(AA aa, TypeInfo keyti, void* pkey)
 
   // first get the runtime function
-  llvm::Function *func = getRuntimeFunction(loc, gIR->module, "_aaDelX");
+  llvm::Function *func = getRuntimeFunction(loc, gIR->module, RTFunc::_aaDelX);
   LLFunctionType *funcTy = func->getFunctionType();
 
   IF_LOG Logger::cout() << "_aaDel = " << *func << '\n';
@@ -198,7 +198,7 @@ LLValue *DtoAAEquals(Loc &loc, TOK op, DValue *l, DValue *r) {
   Type *t = l->type->toBasetype();
   assert(t == r->type->toBasetype() &&
          "aa equality is only defined for aas of same type");
-  llvm::Function *func = getRuntimeFunction(loc, gIR->module, "_aaEqual");
+  llvm::Function *func = getRuntimeFunction(loc, gIR->module, RTFunc::_aaEqual);
   LLFunctionType *funcTy = func->getFunctionType();
 
   LLValue *aaval = DtoBitCast(DtoRVal(l), funcTy->getParamType(1));
@@ -0,0 +1,445 @@
+//===-- arrayops.cpp ------------------------------------------------------===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// The frontend rewrites array operations like `a[] = b[] * c[] + d[]` to a
+// call to a generated function (or a druntime implementation) looping over the
+// elements, e.g.
+//
+//   T[] _arraySliceSliceMulSliceAddSliceAssign_f(T[] p0, T[] p1, T[] p2,
+//                                                 T[] p3) {
+//     foreach (p; 0 .. p0.length)
+//       p0[p] = cast(T)(p1[p] * p2[p] + p3[p]);
+//     return p0;
+//   }
+//
+// When optimizing, such calls are instead lowered to an inline loop over the
+// per-element statement. The lengths of all slices are checked once before
+// the loop (and the destination checked for partial overlap with the source
+// slices), so that the loop body is free of bounds checks. As overlapping
+// operands are illegal, the loop iterations are independent, which is
+// communicated to the loop vectorizer via llvm.mem.parallel_loop_access
+// metadata (no runtime alias checks needed).
+//
+//===----------------------------------------------------------------------===//
+
+#include "gen/arrayops.h"
+#include "declaration.h"
+#include "expression.h"
+#include "id.h"
+#include "module.h"
+#include "statement.h"
+#include "gen/arrays.h"
+#include "gen/dvalue.h"
+#include "gen/irstate.h"
+#include "gen/llvm.h"
+#include "gen/llvmhelpers.h"
+#include "gen/logger.h"
+#include "gen/optimizer.h"
+#include "gen/tollvm.h"
+
+static llvm::cl::opt<bool> disableInlineArrayOps(
+    "disable-inline-arrayops",
+    llvm::cl::desc("Disable the inline lowering of array operations"),
+    llvm::cl::ZeroOrMore);
+
+namespace {
+
+bool isSupportedType(Type *t) {
+  t = t->toBasetype();
+  return (t->isintegral() && t->ty != Tbool) || t->isreal();
+}
+
+Expression *skipOverCasts(Expression *e) {
+  while (e->op == TOKcast) {
+    e = static_cast<CastExp *>(e)->e1;
+  }
+  return e;
+}
+
+/// Creates a self-referencing loop ID, used to mark the memory accesses of a
+/// loop as parallel.
+llvm::MDNode *createLoopID() {
+  llvm::LLVMContext &ctx = gIR->context();
+#if LDC_LLVM_VER >= 306
+  llvm::Metadata *ops[] = {nullptr};
+  llvm::MDNode *loopID = llvm::MDNode::getDistinct(ctx, ops);
+  loopID->replaceOperandWith(0, loopID);
+#else
+  llvm::MDNode *tmp = llvm::MDNode::getTemporary(ctx, llvm::None);
+  llvm::Value *ops[] = {tmp};
+  llvm::MDNode *loopID = llvm::MDNode::get(ctx, ops);
+  loopID->replaceOperandWith(0, loopID);
+  llvm::MDNode::deleteTemporary(tmp);
+#endif
+  return loopID;
+}
+
+class ArrayOpLowering {
+  Loc &loc;
+  FuncDeclaration *fdecl;
+  VarDeclarations &params;
+
+  // Per parameter: the scalar value or the slice length and pointer.
+  std::vector<LLValue *> values;
+  std::vector<LLValue *> lengths;
+
+  LLValue *index = nullptr;
+  llvm::MDNode *loopID = nullptr;
+
+  int paramIndex(Declaration *decl) {
+    for (size_t i = 0; i < params.dim; ++i) {
+      if (params[i] == decl) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  bool isSlice(size_t i) {
+    return params[i]->type->toBasetype()->ty == Tarray;
+  }
+
+  /// Returns the parameter index k for an element `pk[p]`, or -1.
+  int elementParam(Expression *e) {
+    if (e->op != TOKindex) {
+      return -1;
+    }
+    auto ie = static_cast<IndexExp *>(e);
+    if (ie->e1->op != TOKvar || ie->e2->op != TOKvar ||
+        static_cast<VarExp *>(ie->e2)->var->ident != Id::p) {
+      return -1;
+    }
+    const int k = paramIndex(static_cast<VarExp *>(ie->e1)->var);
+    return (k >= 0 && isSlice(k)) ? k : -1;
+  }
+
+  bool isSupported(Expression *e) {
+    if (!isSupportedType(e->type)) {
+      return false;
+    }
+
+    switch (e->op) {
+    case TOKint64:
+    case TOKfloat64:
+      return true;
+    case TOKvar: {
+      const int k = paramIndex(static_cast<VarExp *>(e)->var);
+      return k >= 0 && !isSlice(k);
+    }
+    case TOKindex:
+      return elementParam(e) >= 0;
+    case TOKcast:
+    case TOKneg:
+    case TOKtilde:
+      return isSupported(static_cast<UnaExp *>(e)->e1);
+    case TOKadd:
+    case TOKmin:
+    case TOKmul:
+    case TOKdiv:
+    case TOKmod:
+    case TOKand:
+    case TOKor:
+    case TOKxor: {
+      auto be = static_cast<BinExp *>(e);
+      return isSupported(be->e1) && isSupported(be->e2);
+    }
+    default:
+      return false;
+    }
+  }
+
+  bool isSupportedRoot(Expression *e) {
+    switch (e->op) {
+    case TOKassign: {
+      auto ae = static_cast<AssignExp *>(e);
+      return elementParam(ae->e1) == 0 && isSupportedType(ae->e1->type) &&
+             isSupported(ae->e2);
+    }
+    case TOKaddass:
+    case TOKminass:
+    case TOKmulass:
+    case TOKdivass:
+    case TOKmodass:
+    case TOKandass:
+    case TOKorass:
+    case TOKxorass: {
+      auto be = static_cast<BinAssignExp *>(e);
+      Expression *lval = skipOverCasts(be->e1);
+      return elementParam(lval) == 0 && isSupportedType(lval->type) &&
+             isSupportedType(be->e1->type) && isSupported(be->e2);
+    }
+    default:
+      return false;
+    }
+  }
+
+  LLValue *elementPtr(Expression *e) {
+    const int k = elementParam(e);
+    assert(k >= 0);
+    return DtoGEP1(values[k], index, true, "arrayop.elem");
+  }
+
+  LLValue *loadElement(Expression *e) {
+    auto load = llvm::cast<llvm::LoadInst>(DtoAlignedLoad(elementPtr(e)));
+    load->setMetadata("llvm.mem.parallel_loop_access", loopID);
+    return load;
+  }
+
+  void storeElement(LLValue *val, Expression *e) {
+    llvm::StoreInst *store = gIR->ir->CreateStore(val, elementPtr(e));
+    store->setAlignment(getABITypeAlign(val->getType()));
+    store->setMetadata("llvm.mem.parallel_loop_access", loopID);
+  }
+
+  LLValue *emitBinOp(TOK op, Type *type, DValue *lhs, DValue *rhs) {
+    LLValue *l = DtoRVal(DtoCast(loc, lhs, type));
+    LLValue *r = DtoRVal(DtoCast(loc, rhs, type));
+    const bool fp = type->isfloating();
+    const bool uns = type->isunsigned();
+    auto &ir = gIR->ir;
+
+    switch (op) {
+    case TOKadd:
+    case TOKaddass:
+      return fp ? ir->CreateFAdd(l, r) : ir->CreateAdd(l, r);
+    case TOKmin:
+    case TOKminass:
+      return fp ? ir->CreateFSub(l, r) : ir->CreateSub(l, r);
+    case TOKmul:
+    case TOKmulass:
+      return fp ? ir->CreateFMul(l, r) : ir->CreateMul(l, r);
+    case TOKdiv:
+    case TOKdivass:
+      return fp ? ir->CreateFDiv(l, r)
+                : uns ? ir->CreateUDiv(l, r) : ir->CreateSDiv(l, r);
+    case TOKmod:
+    case TOKmodass:
+      return fp ? ir->CreateFRem(l, r)
+                : uns ? ir->CreateURem(l, r) : ir->CreateSRem(l, r);
+    case TOKand:
+    case TOKandass:
+      return ir->CreateAnd(l, r);
+    case TOKor:
+    case TOKorass:
+      return ir->CreateOr(l, r);
+    case TOKxor:
+    case TOKxorass:
+      return ir->CreateXor(l, r);
+    default:
+      llvm_unreachable("Unexpected array op operator");
+    }
+  }
+
+  DValue *emit(Expression *e) {
+    Type *type = e->type->toBasetype();
+
+    switch (e->op) {
+    case TOKint64:
+    case TOKfloat64:
+      return toElem(e);
+    case TOKvar:
+      return new DImValue(
+          e->type, values[paramIndex(static_cast<VarExp *>(e)->var)]);
+    case TOKindex:
+      return new DImValue(e->type, loadElement(e));
+    case TOKcast: {
+      auto ce = static_cast<CastExp *>(e);
+      DValue *v = DtoCast(loc, emit(ce->e1), ce->to);
+      if (!e->type->equals(ce->to)) {
+        v = DtoPaintType(loc, v, e->type);
+      }
+      return v;
+    }
+    case TOKneg: {
+      LLValue *v = DtoRVal(emit(static_cast<NegExp *>(e)->e1));
+      return new DImValue(e->type, type->isfloating()
+                                       ? gIR->ir->CreateFNeg(v)
+                                       : gIR->ir->CreateNeg(v));
+    }
+    case TOKtilde:
+      return new DImValue(e->type, gIR->ir->CreateNot(DtoRVal(
+                                       emit(static_cast<ComExp *>(e)->e1))));
+    default: {
+      auto be = static_cast<BinExp *>(e);
+      return new DImValue(e->type,
+                          emitBinOp(e->op, type, emit(be->e1), emit(be->e2)));
+    }
+    }
+  }
+
+  void emitRoot(Expression *e) {
+    if (e->op == TOKassign) {
+      auto ae = static_cast<AssignExp *>(e);
+      Type *elemType = ae->e1->type;
+      storeElement(DtoRVal(DtoCast(loc, emit(ae->e2), elemType)), ae->e1);
+      return;
+    }
+
+    // Like the BinAssignExp codegen: the frontend specifies the binop type via
+    // casts of the lhs, e.g., `p0[p] += c1` => `cast(int)p0[p] += c1`.
+    auto be = static_cast<BinAssignExp *>(e);
+    Expression *lval = skipOverCasts(be->e1);
+    Type *opType = be->e1->type->toBasetype();
+    DValue *rhs = emit(be->e2);
+    DValue *lhs = new DImValue(lval->type, loadElement(lval));
+    DImValue result(be->e1->type, emitBinOp(e->op, opType, lhs, rhs));
+    storeElement(DtoRVal(DtoCast(loc, &result, lval->type)), lval);
+  }
+
+  /// Branches to a new block calling the druntime failure function if cond is
+  /// false.
+  void emitCheck(LLValue *cond, bool isOverlapCheck) {
+    llvm::BasicBlock *failbb = llvm::BasicBlock::Create(
+        gIR->context(), "arrayop.fail", gIR->topfunc());
+    llvm::BasicBlock *okbb =
+        llvm::BasicBlock::Create(gIR->context(), "arrayop.ok", gIR->topfunc());
+    gIR->ir->CreateCondBr(cond, okbb, failbb);
+
+    gIR->scope() = IRScope(failbb);
+    if (isOverlapCheck) {
+      DImValue msg(Type::tstring,
+                   DtoConstString("overlapping array operation operands"));
+      DtoAssert(gIR->func()->decl->getModule(), loc, &msg);
+    } else {
+      DtoBoundsCheckFailCall(gIR, loc);
+    }
+
+    gIR->scope() = IRScope(okbb);
+  }
+
+  /// Emits the length check (a RangeError, if array bounds checks are
+  /// enabled) and the overlap check (an assert, if asserts are enabled) of
+  /// the slice operands.
+  void emitChecks(bool checkLengths, bool checkOverlap) {
+    // The element types of the slices may differ, so compare as void*.
+    LLType *voidPtrType = getVoidPtrType();
+    LLValue *length = lengths[0];
+    LLValue *begin = DtoBitCast(values[0], voidPtrType);
+    LLValue *end = DtoBitCast(DtoGEP1(values[0], length, true, "arrayop.end"),
+                              voidPtrType);
+
+    LLValue *sameLengths = nullptr;
+    LLValue *noOverlap = nullptr;
+    for (size_t i = 1; i < params.dim; ++i) {
+      if (!isSlice(i)) {
+        continue;
+      }
+
+      if (checkLengths) {
+        LLValue *eq = gIR->ir->CreateICmpEQ(lengths[i], length);
+        sameLengths = sameLengths ? gIR->ir->CreateAnd(sameLengths, eq) : eq;
+      }
+
+      if (checkOverlap) {
+        // The same slice may be used as destination and source (e.g.,
+        // `a[] = a[] * 2`), but they mustn't overlap partially.
+        LLValue *src = DtoBitCast(values[i], voidPtrType);
+        LLValue *srcEnd = DtoBitCast(
+            DtoGEP1(values[i], length, true, "arrayop.srcend"), voidPtrType);
+        LLValue *disjoint =
+            gIR->ir->CreateOr(gIR->ir->CreateICmpULE(end, src),
+                              gIR->ir->CreateICmpULE(srcEnd, begin));
+        LLValue *ok =
+            gIR->ir->CreateOr(gIR->ir->CreateICmpEQ(src, begin), disjoint);
+        noOverlap = noOverlap ? gIR->ir->CreateAnd(noOverlap, ok) : ok;
+      }
+    }
+
+    if (sameLengths) {
+      emitCheck(sameLengths, false);
+    }
+    if (noOverlap) {
+      emitCheck(noOverlap, true);
+    }
+  }
+
+public:
+  ArrayOpLowering(Loc &loc, FuncDeclaration *fdecl)
+      : loc(loc), fdecl(fdecl), params(*fdecl->parameters) {}
+
+  bool canLower() {
+    Expression *root = fdecl->arrayOpLoopBody->exp;
+    return params.dim > 0 && isSlice(0) && isSupportedRoot(root);
+  }
+
+  DValue *lower(Type *resultType, Expressions *arguments) {
+    assert(arguments->dim == params.dim);
+    values.resize(params.dim);
+    lengths.resize(params.dim);
+
+    // Evaluate the arguments right-to-left, see DtoCallFunction().
+    for (int i = static_cast<int>(params.dim) - 1; i >= 0; --i) {
+      DValue *arg = toElem((*arguments)[i]);
+      if (isSlice(i)) {
+        lengths[i] = DtoArrayLen(arg);
+        values[i] = DtoArrayPtr(arg);
+      } else {
+        values[i] = DtoRVal(DtoCast(loc, arg, params[i]->type));
+      }
+    }
+
+    const bool checkLengths = gIR->emitArrayBoundsChecks();
+    const bool checkOverlap = global.params.useAssert;
+    if (checkLengths || checkOverlap) {
+      emitChecks(checkLengths, checkOverlap);
+    }
+
+    llvm::BasicBlock *condbb = llvm::BasicBlock::Create(
+        gIR->context(), "arrayop.cond", gIR->topfunc());
+    llvm::BasicBlock *bodybb = llvm::BasicBlock::Create(
+        gIR->context(), "arrayop.body", gIR->topfunc());
+    llvm::BasicBlock *endbb =
+        llvm::BasicBlock::Create(gIR->context(), "arrayop.end", gIR->topfunc());
+
+    LLValue *itr = DtoAllocaDump(DtoConstSize_t(0), 0, "arrayop.itr");
+    llvm::BranchInst::Create(condbb, gIR->scopebb());
+
+    gIR->scope() = IRScope(condbb);
+    LLValue *cond =
+        gIR->ir->CreateICmpULT(DtoLoad(itr), lengths[0], "arrayop.condition");
+    llvm::BranchInst::Create(bodybb, endbb, cond, gIR->scopebb());
+
+    gIR->scope() = IRScope(bodybb);
+    index = DtoLoad(itr);
+    loopID = createLoopID();
+    emitRoot(fdecl->arrayOpLoopBody->exp);
+    DtoStore(gIR->ir->CreateNUWAdd(index, DtoConstSize_t(1), "arrayop.next"),
+             itr);
+    llvm::BranchInst::Create(condbb, gIR->scopebb())
+        ->setMetadata("llvm.loop", loopID);
+
+    gIR->scope() = IRScope(endbb);
+
+    return new DSliceValue(resultType, lengths[0], values[0]);
+  }
+};
+}
+
+DValue *DtoInlineArrayOp(Loc &loc, FuncDeclaration *fdecl,
+                         Expressions *arguments) {
+  // Without optimization, the (vectorized) druntime implementations are
+  // faster.
+  if (disableInlineArrayOps || !isOptimizationEnabled() ||
+      !fdecl->arrayOpLoopBody || !fdecl->parameters) {
+    return nullptr;
+  }
+
+  ArrayOpLowering lowering(loc, fdecl);
+  if (!lowering.canLower()) {
+    IF_LOG Logger::println("Array op %s can't be lowered inline",
+                           fdecl->toChars());
+    return nullptr;
+  }
+
+  IF_LOG Logger::println("DtoInlineArrayOp: %s @ %s", fdecl->toChars(),
+                         loc.toChars());
+  LOG_SCOPE;
+
+  return lowering.lower(fdecl->type->nextOf(), arguments);
+}
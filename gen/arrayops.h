@@ -0,0 +1,30 @@
+//===-- gen/arrayops.h - Inline lowering of array operations ----*- C++ -*-===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Lowers calls to the compiler-generated array operation functions (e.g.,
+// `a[] = b[] * c[] + d[]`) to a single inline loop.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LDC_GEN_ARRAYOPS_H
+#define LDC_GEN_ARRAYOPS_H
+
+#include "ddmd/arraytypes.h"
+
+class DValue;
+class FuncDeclaration;
+struct Loc;
+
+/// Emits the array operation fdecl for the given call arguments as an inline
+/// loop. Returns null (without emitting any code) if the operation can't be
+/// lowered, in which case the array op function is to be called normally.
+DValue *DtoInlineArrayOp(Loc &loc, FuncDeclaration *fdecl,
+                         Expressions *arguments);
+
+#endif
@@ -196,7 +196,8 @@ static void copySlice(Loc &loc, LLValue *dstarr, LLValue *sz1, LLValue *srcarr,
   const bool checksEnabled =
       global.params.useAssert || gIR->emitArrayBoundsChecks();
   if (checksEnabled && !knownInBounds) {
-    LLValue *fn = getRuntimeFunction(loc, gIR->module, "_d_array_slice_copy");
+    LLValue *fn =
+        getRuntimeFunction(loc, gIR->module, RTFunc::_d_array_slice_copy);
     gIR->CreateCallOrInvoke(fn, dstarr, sz1, srcarr, sz2);
   } else {
     // We might have dstarr == srcarr at compile time, but as long as
@@ -279,7 +280,8 @@ void DtoArrayAssign(Loc &loc, DValue *lhs, DValue *rhs, int op,
         copySlice(loc, lhsPtr, lhsSize, rhsPtr, rhsSize, knownInBounds);
       }
     } else if (isConstructing) {
-      LLFunction *fn = getRuntimeFunction(loc, gIR->module, "_d_arrayctor");
+      LLFunction *fn =
+          getRuntimeFunction(loc, gIR->module, RTFunc::_d_arrayctor);
       LLCallSite call = gIR->CreateCallOrInvoke(fn, DtoTypeInfoOf(elemType),
                                                 DtoSlice(rhsPtr, rhsLength),
                                                 DtoSlice(lhsPtr, lhsLength));
@@ -289,7 +291,8 @@ void DtoArrayAssign(Loc &loc, DValue *lhs, DValue *rhs, int op,
       LLValue *tmpSwap = DtoAlloca(elemType, "arrayAssign.tmpSwap");
       LLFunction *fn = getRuntimeFunction(
           loc, gIR->module,
-          !canSkipPostblit ? "_d_arrayassign_l" : "_d_arrayassign_r");
+          !canSkipPostblit ? RTFunc::_d_arrayassign_l
+                           : RTFunc::_d_arrayassign_r);
       LLCallSite call = gIR->CreateCallOrInvoke(
           fn, DtoTypeInfoOf(elemType), DtoSlice(rhsPtr, rhsLength),
           DtoSlice(lhsPtr, lhsLength), DtoBitCast(tmpSwap, getVoidPtrType()));
@@ -310,9 +313,9 @@ void DtoArrayAssign(Loc &loc, DValue *lhs, DValue *rhs, int op,
       LLValue *actualLength = gIR->ir->CreateExactUDiv(lhsSize, rhsSize);
       DtoArrayInit(loc, actualPtr, actualLength, rhs, op);
     } else {
-      LLFunction *fn = getRuntimeFunction(loc, gIR->module,
-                                          isConstructing ? "_d_arraysetctor"
-                                                         : "_d_arraysetassign");
+      LLFunction *fn = getRuntimeFunction(
+          loc, gIR->module, isConstructing ? RTFunc::_d_arraysetctor
+                                           : RTFunc::_d_arraysetassign);
       LLCallSite call = gIR->CreateCallOrInvoke(
           fn, lhsPtr, DtoBitCast(makeLValue(loc, rhs), getVoidPtrType()),
           gIR->ir->CreateTruncOrBitCast(lhsLength,
@@ -631,9 +634,9 @@ DSliceValue *DtoNewDynArray(Loc &loc, Type *arrayType, DValue *dim,
   Type *eltType = arrayType->toBasetype()->nextOf();
   bool zeroInit = eltType->isZeroInit();
 
-  const char *fnname = defaultInit
-                           ? (zeroInit ? "_d_newarrayT" : "_d_newarrayiT")
-                           : "_d_newarrayU";
+  RTFunc::Type fnname =
+      defaultInit ? (zeroInit ? RTFunc::_d_newarrayT : RTFunc::_d_newarrayiT)
+                  : RTFunc::_d_newarrayU;
   LLFunction *fn = getRuntimeFunction(loc, gIR->module, fnname);
 
   // call allocator
@@ -660,8 +663,8 @@ DSliceValue *DtoNewMulDimDynArray(Loc &loc, Type *arrayType, DValue **dims,
   }
 
   // get runtime function
-  const char *fnname =
-      vtype->isZeroInit() ? "_d_newarraymTX" : "_d_newarraymiTX";
+  RTFunc::Type fnname =
+      vtype->isZeroInit() ? RTFunc::_d_newarraymTX : RTFunc::_d_newarraymiTX;
   LLFunction *fn = getRuntimeFunction(loc, gIR->module, fnname);
 
   // Check if constant
@@ -729,9 +732,9 @@ DSliceValue *DtoResizeDynArray(Loc &loc, Type *arrayType, DValue *array,
   bool zeroInit = arrayType->toBasetype()->nextOf()->isZeroInit();
 
   // call runtime
-  LLFunction *fn =
-      getRuntimeFunction(loc, gIR->module, zeroInit ? "_d_arraysetlengthT"
-                                                    : "_d_arraysetlengthiT");
+  LLFunction *fn = getRuntimeFunction(
+      loc, gIR->module,
+      zeroInit ? RTFunc::_d_arraysetlengthT : RTFunc::_d_arraysetlengthiT);
 
   LLValue *newArray =
       gIR->CreateCallOrInvoke(
@@ -758,7 +761,8 @@ void DtoCatAssignElement(Loc &loc, Type *arrayType, DValue *array,
   // otherwise a ~= a[$-i] won't work correctly
   DValue *expVal = toElem(exp);
 
-  LLFunction *fn = getRuntimeFunction(loc, gIR->module, "_d_arrayappendcTX");
+  LLFunction *fn =
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_arrayappendcTX);
   LLValue *appendedArray =
       gIR->CreateCallOrInvoke(
              fn, DtoTypeInfoOf(arrayType),
@@ -781,7 +785,8 @@ DSliceValue *DtoCatAssignArray(Loc &loc, DValue *arr, Expression *exp) {
   LOG_SCOPE;
   Type *arrayType = arr->type;
 
-  LLFunction *fn = getRuntimeFunction(loc, gIR->module, "_d_arrayappendT");
+  LLFunction *fn =
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_arrayappendT);
   // Call _d_arrayappendT(TypeInfo ti, byte[] *px, byte[] y)
   LLValue *newArray =
       gIR->CreateCallOrInvoke(
@@ -806,7 +811,7 @@ DSliceValue *DtoCatArrays(Loc &loc, Type *arrayType, Expression *exp1,
   LLFunction *fn = nullptr;
 
   if (exp1->op == TOKcat) { // handle multiple concat
-    fn = getRuntimeFunction(loc, gIR->module, "_d_arraycatnTX");
+    fn = getRuntimeFunction(loc, gIR->module, RTFunc::_d_arraycatnTX);
 
     // Create array of slices
     typedef llvm::SmallVector<llvm::Value *, 16> ArgVector;
@@ -846,7 +851,7 @@ DSliceValue *DtoCatArrays(Loc &loc, Type *arrayType, Expression *exp1,
     // byte[][] arrs
     args.push_back(val);
   } else {
-    fn = getRuntimeFunction(loc, gIR->module, "_d_arraycatT");
+    fn = getRuntimeFunction(loc, gIR->module, RTFunc::_d_arraycatT);
 
     // TypeInfo ti
     args.push_back(DtoTypeInfoOf(arrayType));
@@ -869,7 +874,7 @@ DSliceValue *DtoCatArrays(Loc &loc, Type *arrayType, Expression *exp1,
 ////////////////////////////////////////////////////////////////////////////////
 
 DSliceValue *DtoAppendDChar(Loc &loc, DValue *arr, Expression *exp,
-                            const char *func) {
+                            RTFunc::Type func) {
   LLValue *valueToAppend = DtoRVal(exp);
 
   // Prepare arguments
@@ -892,7 +897,7 @@ DSliceValue *DtoAppendDChar(Loc &loc, DValue *arr, Expression *exp,
 DSliceValue *DtoAppendDCharToString(Loc &loc, DValue *arr, Expression *exp) {
   IF_LOG Logger::println("DtoAppendDCharToString");
   LOG_SCOPE;
-  return DtoAppendDChar(loc, arr, exp, "_d_arrayappendcd");
+  return DtoAppendDChar(loc, arr, exp, RTFunc::_d_arrayappendcd);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -901,12 +906,12 @@ DSliceValue *DtoAppendDCharToUnicodeString(Loc &loc, DValue *arr,
                                            Expression *exp) {
   IF_LOG Logger::println("DtoAppendDCharToUnicodeString");
   LOG_SCOPE;
-  return DtoAppendDChar(loc, arr, exp, "_d_arrayappendwd");
+  return DtoAppendDChar(loc, arr, exp, RTFunc::_d_arrayappendwd);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // helper for eq and cmp
-static LLValue *DtoArrayEqCmp_impl(Loc &loc, const char *func, DValue *l,
+static LLValue *DtoArrayEqCmp_impl(Loc &loc, RTFunc::Type func, DValue *l,
                                    DValue *r, bool useti) {
   IF_LOG Logger::println("comparing arrays");
   LLFunction *fn = getRuntimeFunction(loc, gIR->module, func);
@@ -946,7 +951,7 @@ LLValue *DtoArrayEquals(Loc &loc, TOK op, DValue *l, DValue *r) {
     const auto predicate = eqTokToICmpPred(op);
     res = gIR->ir->CreateICmp(predicate, DtoArrayLen(l), DtoConstSize_t(0));
   } else {
-    res = DtoArrayEqCmp_impl(loc, "_adEq2", l, r, true);
+    res = DtoArrayEqCmp_impl(loc, RTFunc::_adEq2, l, r, true);
     const auto predicate = eqTokToICmpPred(op, /* invert = */ true);
     res = gIR->ir->CreateICmp(predicate, res, DtoConstInt(0));
   }
@@ -963,9 +968,9 @@ LLValue *DtoArrayCompare(Loc &loc, TOK op, DValue *l, DValue *r) {
   if (!res) {
     Type *t = l->type->toBasetype()->nextOf()->toBasetype();
     if (t->ty == Tchar) {
-      res = DtoArrayEqCmp_impl(loc, "_adCmpChar", l, r, false);
+      res = DtoArrayEqCmp_impl(loc, RTFunc::_adCmpChar, l, r, false);
     } else {
-      res = DtoArrayEqCmp_impl(loc, "_adCmp2", l, r, true);
+      res = DtoArrayEqCmp_impl(loc, RTFunc::_adCmp2, l, r, true);
     }
     res = gIR->ir->CreateICmp(cmpop, res, DtoConstInt(0));
   }
@@ -990,7 +995,8 @@ LLValue *DtoArrayCastLength(Loc &loc, LLValue *len, LLType *elemty,
     return len;
   }
 
-  LLFunction *fn = getRuntimeFunction(loc, gIR->module, "_d_array_cast_len");
+  LLFunction *fn =
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_array_cast_len);
   return gIR->CreateCallOrInvoke(fn, len,
                                  LLConstantInt::get(DtoSize_t(), esz, false),
                                  LLConstantInt::get(DtoSize_t(), nsz, false))
@@ -1187,7 +1193,7 @@ void DtoIndexBoundsCheck(Loc &loc, DValue *arr, DValue *index) {
 
 void DtoBoundsCheckFailCall(IRState *irs, Loc &loc) {
   llvm::Function *errorfn =
-      getRuntimeFunction(loc, irs->module, "_d_arraybounds");
+      getRuntimeFunction(loc, irs->module, RTFunc::_d_arraybounds);
   irs->CreateCallOrInvoke(
       errorfn, DtoModuleFileName(irs->func()->decl->getModule(), loc),
       DtoConstUint(loc.linnum));
@@ -63,6 +63,30 @@ typedef enum {
   Reg_XMM5,
   Reg_XMM6,
   Reg_XMM7,
+  Reg_YMM0,
+  Reg_YMM1,
+  Reg_YMM2,
+  Reg_YMM3,
+  Reg_YMM4,
+  Reg_YMM5,
+  Reg_YMM6,
+  Reg_YMM7,
+  Reg_ZMM0,
+  Reg_ZMM1,
+  Reg_ZMM2,
+  Reg_ZMM3,
+  Reg_ZMM4,
+  Reg_ZMM5,
+  Reg_ZMM6,
+  Reg_ZMM7,
+  Reg_K0,
+  Reg_K1,
+  Reg_K2,
+  Reg_K3,
+  Reg_K4,
+  Reg_K5,
+  Reg_K6,
+  Reg_K7,
 
 #ifdef ASM_X86_64
   Reg_RAX,
@@ -113,6 +137,70 @@ typedef enum {
   Reg_XMM13,
   Reg_XMM14,
   Reg_XMM15,
+  Reg_YMM8,
+  Reg_YMM9,
+  Reg_YMM10,
+  Reg_YMM11,
+  Reg_YMM12,
+  Reg_YMM13,
+  Reg_YMM14,
+  Reg_YMM15,
+  Reg_ZMM8,
+  Reg_ZMM9,
+  Reg_ZMM10,
+  Reg_ZMM11,
+  Reg_ZMM12,
+  Reg_ZMM13,
+  Reg_ZMM14,
+  Reg_ZMM15,
+  Reg_XMM16,
+  Reg_XMM17,
+  Reg_XMM18,
+  Reg_XMM19,
+  Reg_XMM20,
+  Reg_XMM21,
+  Reg_XMM22,
+  Reg_XMM23,
+  Reg_XMM24,
+  Reg_XMM25,
+  Reg_XMM26,
+  Reg_XMM27,
+  Reg_XMM28,
+  Reg_XMM29,
+  Reg_XMM30,
+  Reg_XMM31,
+  Reg_YMM16,
+  Reg_YMM17,
+  Reg_YMM18,
+  Reg_YMM19,
+  Reg_YMM20,
+  Reg_YMM21,
+  Reg_YMM22,
+  Reg_YMM23,
+  Reg_YMM24,
+  Reg_YMM25,
+  Reg_YMM26,
+  Reg_YMM27,
+  Reg_YMM28,
+  Reg_YMM29,
+  Reg_YMM30,
+  Reg_YMM31,
+  Reg_ZMM16,
+  Reg_ZMM17,
+  Reg_ZMM18,
+  Reg_ZMM19,
+  Reg_ZMM20,
+  Reg_ZMM21,
+  Reg_ZMM22,
+  Reg_ZMM23,
+  Reg_ZMM24,
+  Reg_ZMM25,
+  Reg_ZMM26,
+  Reg_ZMM27,
+  Reg_ZMM28,
+  Reg_ZMM29,
+  Reg_ZMM30,
+  Reg_ZMM31,
   Reg_RIP,
   Reg_SIL,
   Reg_DIL,
@@ -161,6 +249,7 @@ typedef enum {
 } Reg;
 
 static const int N_Regs = /*gp*/ 8 + /*fp*/ 8 + /*mmx*/ 8 + /*sse*/ 8 +
+                          /*avx*/ 8 + /*avx512*/ 8 + /*opmask*/ 8 +
                           /*seg*/ 6 + /*16bit*/ 8 + /*8bit*/ 8 + /*sys*/ 4 + 6 +
                           5 + /*flags*/ +1
 #ifdef ASM_X86_64
@@ -171,6 +260,9 @@ static const int N_Regs = /*gp*/ 8 + /*fp*/ 8 + /*mmx*/ 8 + /*sse*/ 8 +
                           + 8 /*R8-15W*/
                           + 8 /*R8-15D*/
                           + 8 /*XMM8-15*/
+                          + 8 /*YMM8-15*/
+                          + 8 /*ZMM8-15*/
+                          + 3 * 16 /*XMM16-31, YMM16-31, ZMM16-31*/
                           + 1 /*RIP*/
 #endif
     ;
@@ -183,7 +275,7 @@ static struct {
                        // the clobber list)
   Identifier *ident;
   char size;
-  signed char baseReg; // %% todo: Reg, Reg_XX
+  short baseReg; // %% todo: Reg, Reg_XX
 } regInfo[N_Regs] = {
     {"EAX", NULL_TREE, nullptr, 4, Reg_EAX},
     {"EBX", NULL_TREE, nullptr, 4, Reg_EBX},
@@ -217,6 +309,30 @@ static struct {
     {"XMM5", NULL_TREE, nullptr, 16, Reg_XMM5},
     {"XMM6", NULL_TREE, nullptr, 16, Reg_XMM6},
     {"XMM7", NULL_TREE, nullptr, 16, Reg_XMM7},
+    {"YMM0", NULL_TREE, nullptr, 32, Reg_YMM0},
+    {"YMM1", NULL_TREE, nullptr, 32, Reg_YMM1},
+    {"YMM2", NULL_TREE, nullptr, 32, Reg_YMM2},
+    {"YMM3", NULL_TREE, nullptr, 32, Reg_YMM3},
+    {"YMM4", NULL_TREE, nullptr, 32, Reg_YMM4},
+    {"YMM5", NULL_TREE, nullptr, 32, Reg_YMM5},
+    {"YMM6", NULL_TREE, nullptr, 32, Reg_YMM6},
+    {"YMM7", NULL_TREE, nullptr, 32, Reg_YMM7},
+    {"ZMM0", NULL_TREE, nullptr, 64, Reg_ZMM0},
+    {"ZMM1", NULL_TREE, nullptr, 64, Reg_ZMM1},
+    {"ZMM2", NULL_TREE, nullptr, 64, Reg_ZMM2},
+    {"ZMM3", NULL_TREE, nullptr, 64, Reg_ZMM3},
+    {"ZMM4", NULL_TREE, nullptr, 64, Reg_ZMM4},
+    {"ZMM5", NULL_TREE, nullptr, 64, Reg_ZMM5},
+    {"ZMM6", NULL_TREE, nullptr, 64, Reg_ZMM6},
+    {"ZMM7", NULL_TREE, nullptr, 64, Reg_ZMM7},
+    {"K0", NULL_TREE, nullptr, 8, Reg_K0},
+    {"K1", NULL_TREE, nullptr, 8, Reg_K1},
+    {"K2", NULL_TREE, nullptr, 8, Reg_K2},
+    {"K3", NULL_TREE, nullptr, 8, Reg_K3},
+    {"K4", NULL_TREE, nullptr, 8, Reg_K4},
+    {"K5", NULL_TREE, nullptr, 8, Reg_K5},
+    {"K6", NULL_TREE, nullptr, 8, Reg_K6},
+    {"K7", NULL_TREE, nullptr, 8, Reg_K7},
 
 #ifdef ASM_X86_64
     {"RAX", NULL_TREE, nullptr, 8, Reg_RAX},
@@ -267,6 +383,70 @@ static struct {
     {"XMM13", NULL_TREE, nullptr, 16, Reg_XMM13},
     {"XMM14", NULL_TREE, nullptr, 16, Reg_XMM14},
     {"XMM15", NULL_TREE, nullptr, 16, Reg_XMM15},
+    {"YMM8", NULL_TREE, nullptr, 32, Reg_YMM8},
+    {"YMM9", NULL_TREE, nullptr, 32, Reg_YMM9},
+    {"YMM10", NULL_TREE, nullptr, 32, Reg_YMM10},
+    {"YMM11", NULL_TREE, nullptr, 32, Reg_YMM11},
+    {"YMM12", NULL_TREE, nullptr, 32, Reg_YMM12},
+    {"YMM13", NULL_TREE, nullptr, 32, Reg_YMM13},
+    {"YMM14", NULL_TREE, nullptr, 32, Reg_YMM14},
+    {"YMM15", NULL_TREE, nullptr, 32, Reg_YMM15},
+    {"ZMM8", NULL_TREE, nullptr, 64, Reg_ZMM8},
+    {"ZMM9", NULL_TREE, nullptr, 64, Reg_ZMM9},
+    {"ZMM10", NULL_TREE, nullptr, 64, Reg_ZMM10},
+    {"ZMM11", NULL_TREE, nullptr, 64, Reg_ZMM11},
+    {"ZMM12", NULL_TREE, nullptr, 64, Reg_ZMM12},
+    {"ZMM13", NULL_TREE, nullptr, 64, Reg_ZMM13},
+    {"ZMM14", NULL_TREE, nullptr, 64, Reg_ZMM14},
+    {"ZMM15", NULL_TREE, nullptr, 64, Reg_ZMM15},
+    {"XMM16", NULL_TREE, nullptr, 16, Reg_XMM16},
+    {"XMM17", NULL_TREE, nullptr, 16, Reg_XMM17},
+    {"XMM18", NULL_TREE, nullptr, 16, Reg_XMM18},
+    {"XMM19", NULL_TREE, nullptr, 16, Reg_XMM19},
+    {"XMM20", NULL_TREE, nullptr, 16, Reg_XMM20},
+    {"XMM21", NULL_TREE, nullptr, 16, Reg_XMM21},
+    {"XMM22", NULL_TREE, nullptr, 16, Reg_XMM22},
+    {"XMM23", NULL_TREE, nullptr, 16, Reg_XMM23},
+    {"XMM24", NULL_TREE, nullptr, 16, Reg_XMM24},
+    {"XMM25", NULL_TREE, nullptr, 16, Reg_XMM25},
+    {"XMM26", NULL_TREE, nullptr, 16, Reg_XMM26},
+    {"XMM27", NULL_TREE, nullptr, 16, Reg_XMM27},
+    {"XMM28", NULL_TREE, nullptr, 16, Reg_XMM28},
+    {"XMM29", NULL_TREE, nullptr, 16, Reg_XMM29},
+    {"XMM30", NULL_TREE, nullptr, 16, Reg_XMM30},
+    {"XMM31", NULL_TREE, nullptr, 16, Reg_XMM31},
+    {"YMM16", NULL_TREE, nullptr, 32, Reg_YMM16},
+    {"YMM17", NULL_TREE, nullptr, 32, Reg_YMM17},
+    {"YMM18", NULL_TREE, nullptr, 32, Reg_YMM18},
+    {"YMM19", NULL_TREE, nullptr, 32, Reg_YMM19},
+    {"YMM20", NULL_TREE, nullptr, 32, Reg_YMM20},
+    {"YMM21", NULL_TREE, nullptr, 32, Reg_YMM21},
+    {"YMM22", NULL_TREE, nullptr, 32, Reg_YMM22},
+    {"YMM23", NULL_TREE, nullptr, 32, Reg_YMM23},
+    {"YMM24", NULL_TREE, nullptr, 32, Reg_YMM24},
+    {"YMM25", NULL_TREE, nullptr, 32, Reg_YMM25},
+    {"YMM26", NULL_TREE, nullptr, 32, Reg_YMM26},
+    {"YMM27", NULL_TREE, nullptr, 32, Reg_YMM27},
+    {"YMM28", NULL_TREE, nullptr, 32, Reg_YMM28},
+    {"YMM29", NULL_TREE, nullptr, 32, Reg_YMM29},
+    {"YMM30", NULL_TREE, nullptr, 32, Reg_YMM30},
+    {"YMM31", NULL_TREE, nullptr, 32, Reg_YMM31},
+    {"ZMM16", NULL_TREE, nullptr, 64, Reg_ZMM16},
+    {"ZMM17", NULL_TREE, nullptr, 64, Reg_ZMM17},
+    {"ZMM18", NULL_TREE, nullptr, 64, Reg_ZMM18},
+    {"ZMM19", NULL_TREE, nullptr, 64, Reg_ZMM19},
+    {"ZMM20", NULL_TREE, nullptr, 64, Reg_ZMM20},
+    {"ZMM21", NULL_TREE, nullptr, 64, Reg_ZMM21},
+    {"ZMM22", NULL_TREE, nullptr, 64, Reg_ZMM22},
+    {"ZMM23", NULL_TREE, nullptr, 64, Reg_ZMM23},
+    {"ZMM24", NULL_TREE, nullptr, 64, Reg_ZMM24},
+    {"ZMM25", NULL_TREE, nullptr, 64, Reg_ZMM25},
+    {"ZMM26", NULL_TREE, nullptr, 64, Reg_ZMM26},
+    {"ZMM27", NULL_TREE, nullptr, 64, Reg_ZMM27},
+    {"ZMM28", NULL_TREE, nullptr, 64, Reg_ZMM28},
+    {"ZMM29", NULL_TREE, nullptr, 64, Reg_ZMM29},
+    {"ZMM30", NULL_TREE, nullptr, 64, Reg_ZMM30},
+    {"ZMM31", NULL_TREE, nullptr, 64, Reg_ZMM31},
     {"RIP", NULL_TREE, nullptr, 8, Reg_RIP},
     {"SIL", NULL_TREE, nullptr, 1, Reg_SIL},
     {"DIL", NULL_TREE, nullptr, 1, Reg_DIL},
@@ -364,6 +544,14 @@ typedef enum {
   Op_DstSrcImmS,
   Op_DstSrcImmM,
   Op_ExtSrcImmS,
+  Op_DstSrcAVX,
+  Op_DstSrcSrcS,
+  Op_UpdSrcSrcS,
+  Op_DstSrcSrcSrcS,
+  Op_UpdSrcSrcImmS,
+  Op_GatherV,
+  Op_GatherK,
+  Op_ScatterK,
   Op_UpdSrcShft,
   Op_DstSrcNT,
   Op_UpdSrcNT,
@@ -464,6 +652,8 @@ typedef enum {
   Op_out,
   Op_outs,
   Op_outsX,
+  Op_pcmpstri,
+  Op_pcmpstrm,
   Op_push,
   Op_ret,
   Op_retf,
@@ -471,6 +661,7 @@ typedef enum {
   Op_scasX,
   Op_stos,
   Op_stosX,
+  Op_vzero,
   Op_xgetbv,
   Op_xlat,
   N_AsmOpInfo,
@@ -521,7 +712,7 @@ typedef struct {
 typedef unsigned char Opr;
 
 typedef struct {
-  Opr operands[3];
+  Opr operands[4];
 #ifndef ASM_X86_64
   unsigned char needsType : 3, implicitClobbers : 8, linkType : 2;
 #else
@@ -539,7 +730,10 @@ typedef struct {
     if (!operands[2]) {
       return 2;
     }
-    return 3;
+    if (!operands[3]) {
+      return 3;
+    }
+    return 4;
   }
 } AsmOpInfo;
 
@@ -618,6 +812,22 @@ static AsmOpInfo asmOpInfo[N_AsmOpInfo] = {
     /* Op_DstSrcImmS*/ {{U | sse, ssem, N | imm}}, // some may not be update %%
     /* Op_DstSrcImmM*/ {{U | mmx, mmxm, N | imm}}, // some may not be update %%
     /* Op_ExtSrcImmS*/ {{D | mr, sse, N | imm}},   // used for extractps
+    /* Op_DstSrcAVX */ {{D | sse, ssem, 0},
+                        0,
+                        0,
+                        Next_Form,
+                        Op_DstSrcSrcS}, // e.g. vmovss: memory or 3-reg form
+    /* Op_DstSrcSrcS*/ {{D | sse, sse, ssem}},
+    /* Op_UpdSrcSrcS*/ {{U | sse, sse, ssem}}, // e.g. FMA, vpermt2*
+    /* Op_DstSrcSrcSrcS */ {{D | sse, sse, ssem, N | imm}}, // or 4th reg
+    /* Op_UpdSrcSrcImmS */ {{U | sse, sse, ssem, N | imm}}, // vpternlog*
+    /* Op_GatherV   */ {{D | sse, mem, U | sse},
+                        0,
+                        0,
+                        Next_Form,
+                        Op_GatherK}, // the mask is cleared
+    /* Op_GatherK   */ {{D | sse, mem, 0}}, // AVX-512: the opmask is cleared
+    /* Op_ScatterK  */ {{D | mem, sse, 0}}, // AVX-512: the opmask is cleared
     /* Op_UpdSrcShft*/ {{U | mr, reg, N | shft}, 1, Clb_Flags}, // 16/32 only
     /* Op_DstSrcNT  */ {{D | mr, mr, 0},
                         0}, // used for movd .. operands can be rm32,sse,mmx
@@ -800,6 +1010,8 @@ static AsmOpInfo asmOpInfo[N_AsmOpInfo] = {
     /* Op_out       */ {{N | port, ax, 0}, 1},
     /* Op_outs      */ {{N | dx, mem, 0}, 1, Clb_SI},
     /* Op_outsX     */ {{0, 0, 0}, 0, Clb_SI},
+    /* Op_pcmpstri  */ {{sse, ssem, N | imm}, 0, Clb_CX | Clb_Flags},
+    /* Op_pcmpstrm  */ {{sse, ssem, N | imm}, 0, Clb_Flags}, // writes XMM0
 #ifndef ASM_X86_64
     /* Op_push      */ {{mri, 0, 0}, Word_Types, Clb_SP}, // would be Op_SrcW,
                                                           // but DMD defaults to
@@ -816,6 +1028,7 @@ static AsmOpInfo asmOpInfo[N_AsmOpInfo] = {
     /* Op_scasX     */ {{0, 0, 0}, 0, Clb_DI | Clb_Flags},
     /* Op_stos      */ {{mem, 0, 0}, 1, Clb_DI},
     /* Op_stosX     */ {{0, 0, 0}, 0, Clb_DI},
+    /* Op_vzero     */ {{0, 0, 0}}, // clears (the upper halves of) all YMM
 #ifndef ASM_X86_64
     /* Op_xgetbv    */ {{0, 0, 0}, 0, Clb_SizeDXAX},
 #else
@@ -1204,6 +1417,57 @@ static AsmOpEnt opData[] = {
 #endif
     {"js", Op_CBranch},
     {"jz", Op_CBranch},
+    {"kaddb", Op_DstSrcSrcS},
+    {"kaddd", Op_DstSrcSrcS},
+    {"kaddq", Op_DstSrcSrcS},
+    {"kaddw", Op_DstSrcSrcS},
+    {"kandb", Op_DstSrcSrcS},
+    {"kandd", Op_DstSrcSrcS},
+    {"kandnb", Op_DstSrcSrcS},
+    {"kandnd", Op_DstSrcSrcS},
+    {"kandnq", Op_DstSrcSrcS},
+    {"kandnw", Op_DstSrcSrcS},
+    {"kandq", Op_DstSrcSrcS},
+    {"kandw", Op_DstSrcSrcS},
+    {"kmovb", Op_DstSrcNT},
+    {"kmovd", Op_DstSrcNT},
+    {"kmovq", Op_DstSrcNT},
+    {"kmovw", Op_DstSrcNT},
+    {"knotb", Op_DstSrcSSE},
+    {"knotd", Op_DstSrcSSE},
+    {"knotq", Op_DstSrcSSE},
+    {"knotw", Op_DstSrcSSE},
+    {"korb", Op_DstSrcSrcS},
+    {"kord", Op_DstSrcSrcS},
+    {"korq", Op_DstSrcSrcS},
+    {"kortestb", Op_SrcSrcSSEF},
+    {"kortestd", Op_SrcSrcSSEF},
+    {"kortestq", Op_SrcSrcSSEF},
+    {"kortestw", Op_SrcSrcSSEF},
+    {"korw", Op_DstSrcSrcS},
+    {"kshiftlb", Op_DstSrcSrcS},
+    {"kshiftld", Op_DstSrcSrcS},
+    {"kshiftlq", Op_DstSrcSrcS},
+    {"kshiftlw", Op_DstSrcSrcS},
+    {"kshiftrb", Op_DstSrcSrcS},
+    {"kshiftrd", Op_DstSrcSrcS},
+    {"kshiftrq", Op_DstSrcSrcS},
+    {"kshiftrw", Op_DstSrcSrcS},
+    {"ktestb", Op_SrcSrcSSEF},
+    {"ktestd", Op_SrcSrcSSEF},
+    {"ktestq", Op_SrcSrcSSEF},
+    {"ktestw", Op_SrcSrcSSEF},
+    {"kunpckbw", Op_DstSrcSrcS},
+    {"kunpckdq", Op_DstSrcSrcS},
+    {"kunpckwd", Op_DstSrcSrcS},
+    {"kxnorb", Op_DstSrcSrcS},
+    {"kxnord", Op_DstSrcSrcS},
+    {"kxnorq", Op_DstSrcSrcS},
+    {"kxnorw", Op_DstSrcSrcS},
+    {"kxorb", Op_DstSrcSrcS},
+    {"kxord", Op_DstSrcSrcS},
+    {"kxorq", Op_DstSrcSrcS},
+    {"kxorw", Op_DstSrcSrcS},
     {"lahf", Op_0_AX},
     {"lar", Op_DstSrcFW}, // reg dest only
     {"lddqu", Op_DstSrcSSE},
@@ -1646,303 +1910,573 @@ static AsmOpEnt opData[] = {
     {"unpckhps", Op_UpdSrcSSE},
     {"unpcklpd", Op_UpdSrcSSE},
     {"unpcklps", Op_UpdSrcSSE},
-#if 0 // TODO
-    {"vaddpd", XXXX},
-    {"vaddps", XXXX},
-    {"vaddsd", XXXX},
-    {"vaddss", XXXX},
-    {"vaddsubpd", XXXX},
-    {"vaddsubps", XXXX},
-    {"vaesdec", XXXX},
-    {"vaesdeclast", XXXX},
-    {"vaesenc", XXXX},
-    {"vaesenclast", XXXX},
-    {"vaesimc", XXXX},
-    {"vaeskeygenassist", XXXX},
-    {"vandnpd", XXXX},
-    {"vandnps", XXXX},
-    {"vandpd", XXXX},
-    {"vandps", XXXX},
-    {"vblendpd", XXXX},
-    {"vblendps", XXXX},
-    {"vblendvpd", XXXX},
-    {"vblendvps", XXXX},
-    {"vbroadcastf128", XXXX},
-    {"vbroadcastsd", XXXX},
-    {"vbroadcastss", XXXX},
-    {"vcmppd", XXXX},
-    {"vcmpps", XXXX},
-    {"vcmpsd", XXXX},
-    {"vcmpss", XXXX},
-    {"vcomisd", XXXX},
-    {"vcomiss", XXXX},
-    {"vcvtdq2pd", XXXX},
-    {"vcvtdq2ps", XXXX},
-    {"vcvtpd2dq", XXXX},
-    {"vcvtpd2ps", XXXX},
-    {"vcvtph2ps", XXXX},
-    {"vcvtps2dq", XXXX},
-    {"vcvtps2pd", XXXX},
-    {"vcvtps2ph", XXXX},
-    {"vcvtsd2si", XXXX},
-    {"vcvtsd2ss", XXXX},
-    {"vcvtsi2sd", XXXX},
-    {"vcvtsi2ss", XXXX},
-    {"vcvtss2sd", XXXX},
-    {"vcvtss2si", XXXX},
-    {"vcvttpd2dq", XXXX},
-    {"vcvttps2dq", XXXX},
-    {"vcvttsd2si", XXXX},
-    {"vcvttss2si", XXXX},
-    {"vdivpd", XXXX},
-    {"vdivps", XXXX},
-    {"vdivsd", XXXX},
-    {"vdivss", XXXX},
-    {"vdppd", XXXX},
-    {"vdpps", XXXX},
-#endif
+    {"vaddpd", Op_DstSrcSrcS},
+    {"vaddps", Op_DstSrcSrcS},
+    {"vaddsd", Op_DstSrcSrcS},
+    {"vaddss", Op_DstSrcSrcS},
+    {"vaddsubpd", Op_DstSrcSrcS},
+    {"vaddsubps", Op_DstSrcSrcS},
+    {"vaesdec", Op_DstSrcSrcS},
+    {"vaesdeclast", Op_DstSrcSrcS},
+    {"vaesenc", Op_DstSrcSrcS},
+    {"vaesenclast", Op_DstSrcSrcS},
+    {"vaesimc", Op_DstSrcSSE},
+    {"vaeskeygenassist", Op_DstSrcSrcS},
+    {"valignd", Op_DstSrcSrcSrcS},
+    {"valignq", Op_DstSrcSrcSrcS},
+    {"vandnpd", Op_DstSrcSrcS},
+    {"vandnps", Op_DstSrcSrcS},
+    {"vandpd", Op_DstSrcSrcS},
+    {"vandps", Op_DstSrcSrcS},
+    {"vblendmpd", Op_DstSrcSrcS},
+    {"vblendmps", Op_DstSrcSrcS},
+    {"vblendpd", Op_DstSrcSrcSrcS},
+    {"vblendps", Op_DstSrcSrcSrcS},
+    {"vblendvpd", Op_DstSrcSrcSrcS},
+    {"vblendvps", Op_DstSrcSrcSrcS},
+    {"vbroadcastf128", Op_DstSrcSSE},
+    {"vbroadcastf32x2", Op_DstSrcSSE},
+    {"vbroadcastf32x4", Op_DstSrcSSE},
+    {"vbroadcastf32x8", Op_DstSrcSSE},
+    {"vbroadcastf64x2", Op_DstSrcSSE},
+    {"vbroadcastf64x4", Op_DstSrcSSE},
+    {"vbroadcasti128", Op_DstSrcSSE},
+    {"vbroadcasti32x2", Op_DstSrcSSE},
+    {"vbroadcasti32x4", Op_DstSrcSSE},
+    {"vbroadcasti32x8", Op_DstSrcSSE},
+    {"vbroadcasti64x2", Op_DstSrcSSE},
+    {"vbroadcasti64x4", Op_DstSrcSSE},
+    {"vbroadcastsd", Op_DstSrcSSE},
+    {"vbroadcastss", Op_DstSrcSSE},
+    {"vcmppd", Op_DstSrcSrcSrcS},
+    {"vcmpps", Op_DstSrcSrcSrcS},
+    {"vcmpsd", Op_DstSrcSrcSrcS},
+    {"vcmpss", Op_DstSrcSrcSrcS},
+    {"vcomisd", Op_SrcSrcSSEF},
+    {"vcomiss", Op_SrcSrcSSEF},
+    {"vcompresspd", Op_DstSrcSSE},
+    {"vcompressps", Op_DstSrcSSE},
+    {"vcvtdq2pd", Op_DstSrcSSE},
+    {"vcvtdq2ps", Op_DstSrcSSE},
+    {"vcvtpd2dq", Op_DstSrcSSE},
+    {"vcvtpd2ps", Op_DstSrcSSE},
+    {"vcvtpd2qq", Op_DstSrcSSE},
+    {"vcvtpd2udq", Op_DstSrcSSE},
+    {"vcvtpd2uqq", Op_DstSrcSSE},
+    {"vcvtph2ps", Op_DstSrcSSE},
+    {"vcvtps2dq", Op_DstSrcSSE},
+    {"vcvtps2pd", Op_DstSrcSSE},
+    {"vcvtps2ph", Op_DstSrcSrcS},
+    {"vcvtps2qq", Op_DstSrcSSE},
+    {"vcvtps2udq", Op_DstSrcSSE},
+    {"vcvtps2uqq", Op_DstSrcSSE},
+    {"vcvtqq2pd", Op_DstSrcSSE},
+    {"vcvtqq2ps", Op_DstSrcSSE},
+    {"vcvtsd2si", Op_DstSrcSSE},
+    {"vcvtsd2ss", Op_DstSrcSrcS},
+    {"vcvtsd2usi", Op_DstSrcSSE},
+    {"vcvtsi2sd", Op_DstSrcSrcS},
+    {"vcvtsi2ss", Op_DstSrcSrcS},
+    {"vcvtss2sd", Op_DstSrcSrcS},
+    {"vcvtss2si", Op_DstSrcSSE},
+    {"vcvtss2usi", Op_DstSrcSSE},
+    {"vcvttpd2dq", Op_DstSrcSSE},
+    {"vcvttpd2qq", Op_DstSrcSSE},
+    {"vcvttpd2udq", Op_DstSrcSSE},
+    {"vcvttpd2uqq", Op_DstSrcSSE},
+    {"vcvttps2dq", Op_DstSrcSSE},
+    {"vcvttps2qq", Op_DstSrcSSE},
+    {"vcvttps2udq", Op_DstSrcSSE},
+    {"vcvttps2uqq", Op_DstSrcSSE},
+    {"vcvttsd2si", Op_DstSrcSSE},
+    {"vcvttsd2usi", Op_DstSrcSSE},
+    {"vcvttss2si", Op_DstSrcSSE},
+    {"vcvttss2usi", Op_DstSrcSSE},
+    {"vcvtudq2pd", Op_DstSrcSSE},
+    {"vcvtudq2ps", Op_DstSrcSSE},
+    {"vcvtuqq2pd", Op_DstSrcSSE},
+    {"vcvtuqq2ps", Op_DstSrcSSE},
+    {"vcvtusi2sd", Op_DstSrcSrcS},
+    {"vcvtusi2ss", Op_DstSrcSrcS},
+    {"vdbpsadbw", Op_DstSrcSrcSrcS},
+    {"vdivpd", Op_DstSrcSrcS},
+    {"vdivps", Op_DstSrcSrcS},
+    {"vdivsd", Op_DstSrcSrcS},
+    {"vdivss", Op_DstSrcSrcS},
+    {"vdppd", Op_DstSrcSrcSrcS},
+    {"vdpps", Op_DstSrcSrcSrcS},
     {"verr", Op_SrcMemNTF},
     {"verw", Op_SrcMemNTF},
-#if 0 // TODO
-    {"vextractf128", XXXX},
-    {"vextractps", XXXX},
-    {"vfmadd132pd", XXXX},
-    {"vfmadd132ps", XXXX},
-    {"vfmadd132sd", XXXX},
-    {"vfmadd132ss", XXXX},
-    {"vfmadd213pd", XXXX},
-    {"vfmadd213ps", XXXX},
-    {"vfmadd213sd", XXXX},
-    {"vfmadd213ss", XXXX},
-    {"vfmadd231pd", XXXX},
-    {"vfmadd231ps", XXXX},
-    {"vfmadd231sd", XXXX},
-    {"vfmadd231ss", XXXX},
-    {"vfmaddsub132pd", XXXX},
-    {"vfmaddsub132ps", XXXX},
-    {"vfmaddsub213pd", XXXX},
-    {"vfmaddsub213ps", XXXX},
-    {"vfmaddsub231pd", XXXX},
-    {"vfmaddsub231ps", XXXX},
-    {"vfmsub132pd", XXXX},
-    {"vfmsub132ps", XXXX},
-    {"vfmsub132sd", XXXX},
-    {"vfmsub132ss", XXXX},
-    {"vfmsub213pd", XXXX},
-    {"vfmsub213ps", XXXX},
-    {"vfmsub213sd", XXXX},
-    {"vfmsub213ss", XXXX},
-    {"vfmsub231pd", XXXX},
-    {"vfmsub231ps", XXXX},
-    {"vfmsub231sd", XXXX},
-    {"vfmsub231ss", XXXX},
-    {"vfmsubadd132pd", XXXX},
-    {"vfmsubadd132ps", XXXX},
-    {"vfmsubadd213pd", XXXX},
-    {"vfmsubadd213ps", XXXX},
-    {"vfmsubadd231pd", XXXX},
-    {"vfmsubadd231ps", XXXX},
-    {"vhaddpd", XXXX},
-    {"vhaddps", XXXX},
-    {"vinsertf128", XXXX},
-    {"vinsertps", XXXX},
-    {"vlddqu", XXXX},
-    {"vldmxcsr", XXXX},
-    {"vmaskmovdqu", XXXX},
-    {"vmaskmovpd", XXXX},
-    {"vmaskmovps", XXXX},
-    {"vmaxpd", XXXX},
-    {"vmaxps", XXXX},
-    {"vmaxsd", XXXX},
-    {"vmaxss", XXXX},
-    {"vminpd", XXXX},
-    {"vminps", XXXX},
-    {"vminsd", XXXX},
-    {"vminss", XXXX},
-    {"vmovapd", XXXX},
-    {"vmovaps", XXXX},
-    {"vmovd", XXXX},
-    {"vmovddup", XXXX},
-    {"vmovdqa", XXXX},
-    {"vmovdqu", XXXX},
-    {"vmovhlps", XXXX},
-    {"vmovhpd", XXXX},
-    {"vmovhps", XXXX},
-    {"vmovlhps", XXXX},
-    {"vmovlpd", XXXX},
-    {"vmovlps", XXXX},
-    {"vmovmskpd", XXXX},
-    {"vmovmskps", XXXX},
-    {"vmovntdq", XXXX},
-    {"vmovntdqa", XXXX},
-    {"vmovntpd", XXXX},
-    {"vmovntps", XXXX},
-    {"vmovq", XXXX},
-    {"vmovsd", XXXX},
-    {"vmovshdup", XXXX},
-    {"vmovsldup", XXXX},
-    {"vmovss", XXXX},
-    {"vmovupd", XXXX},
-    {"vmovups", XXXX},
-    {"vmpsadbw", XXXX},
-    {"vmulpd", XXXX},
-    {"vmulps", XXXX},
-    {"vmulsd", XXXX},
-    {"vmulss", XXXX},
-    {"vorpd", XXXX},
-    {"vorps", XXXX},
-    {"vpabsb", XXXX},
-    {"vpabsd", XXXX},
-    {"vpabsw", XXXX},
-    {"vpackssdw", XXXX},
-    {"vpacksswb", XXXX},
-    {"vpackusdw", XXXX},
-    {"vpackuswb", XXXX},
-    {"vpaddb", XXXX},
-    {"vpaddd", XXXX},
-    {"vpaddq", XXXX},
-    {"vpaddsb", XXXX},
-    {"vpaddsw", XXXX},
-    {"vpaddusb", XXXX},
-    {"vpaddusw", XXXX},
-    {"vpaddw", XXXX},
-    {"vpalignr", XXXX},
-    {"vpand", XXXX},
-    {"vpandn", XXXX},
-    {"vpavgb", XXXX},
-    {"vpavgw", XXXX},
-    {"vpblendvb", XXXX},
-    {"vpblendw", XXXX},
-    {"vpclmulqdq", XXXX},
-    {"vpcmpeqb", XXXX},
-    {"vpcmpeqd", XXXX},
-    {"vpcmpeqq", XXXX},
-    {"vpcmpeqw", XXXX},
-    {"vpcmpestri", XXXX},
-    {"vpcmpestrm", XXXX},
-    {"vpcmpgtb", XXXX},
-    {"vpcmpgtd", XXXX},
-    {"vpcmpgtq", XXXX},
-    {"vpcmpgtw", XXXX},
-    {"vpcmpistri", XXXX},
-    {"vpcmpistrm", XXXX},
-    {"vperm2f128", XXXX},
-    {"vpermilpd", XXXX},
-    {"vpermilps", XXXX},
-    {"vpextrb", XXXX},
-    {"vpextrd", XXXX},
-    {"vpextrq", XXXX},
-    {"vpextrw", XXXX},
-    {"vphaddd", XXXX},
-    {"vphaddsw", XXXX},
-    {"vphaddw", XXXX},
-    {"vphminposuw", XXXX},
-    {"vphsubd", XXXX},
-    {"vphsubsw", XXXX},
-    {"vphsubw", XXXX},
-    {"vpinsrb", XXXX},
-    {"vpinsrd", XXXX},
-    {"vpinsrq", XXXX},
-    {"vpinsrw", XXXX},
-    {"vpmaddubsw", XXXX},
-    {"vpmaddwd", XXXX},
-    {"vpmaxsb", XXXX},
-    {"vpmaxsd", XXXX},
-    {"vpmaxsw", XXXX},
-    {"vpmaxub", XXXX},
-    {"vpmaxud", XXXX},
-    {"vpmaxuw", XXXX},
-    {"vpminsb", XXXX},
-    {"vpminsd", XXXX},
-    {"vpminsw", XXXX},
-    {"vpminub", XXXX},
-    {"vpminud", XXXX},
-    {"vpminuw", XXXX},
-    {"vpmovmskb", XXXX},
-    {"vpmovsxbd", XXXX},
-    {"vpmovsxbq", XXXX},
-    {"vpmovsxbw", XXXX},
-    {"vpmovsxdq", XXXX},
-    {"vpmovsxwd", XXXX},
-    {"vpmovsxwq", XXXX},
-    {"vpmovzxbd", XXXX},
-    {"vpmovzxbq", XXXX},
-    {"vpmovzxbw", XXXX},
-    {"vpmovzxdq", XXXX},
-    {"vpmovzxwd", XXXX},
-    {"vpmovzxwq", XXXX},
-    {"vpmuldq", XXXX},
-    {"vpmulhrsw", XXXX},
-    {"vpmulhuw", XXXX},
-    {"vpmulhw", XXXX},
-    {"vpmulld", XXXX},
-    {"vpmullw", XXXX},
-    {"vpmuludq", XXXX},
-    {"vpor", XXXX},
-    {"vpsadbw", XXXX},
-    {"vpshufb", XXXX},
-    {"vpshufd", XXXX},
-    {"vpshufhw", XXXX},
-    {"vpshuflw", XXXX},
-    {"vpsignb", XXXX},
-    {"vpsignd", XXXX},
-    {"vpsignw", XXXX},
-    {"vpslld", XXXX},
-    {"vpslldq", XXXX},
-    {"vpsllq", XXXX},
-    {"vpsllw", XXXX},
-    {"vpsrad", XXXX},
-    {"vpsraw", XXXX},
-    {"vpsrld", XXXX},
-    {"vpsrldq", XXXX},
-    {"vpsrlq", XXXX},
-    {"vpsrlw", XXXX},
-    {"vpsubb", XXXX},
-    {"vpsubd", XXXX},
-    {"vpsubq", XXXX},
-    {"vpsubsb", XXXX},
-    {"vpsubsw", XXXX},
-    {"vpsubusb", XXXX},
-    {"vpsubusw", XXXX},
-    {"vpsubw", XXXX},
-    {"vptest", XXXX},
-    {"vpunpckhbw", XXXX},
-    {"vpunpckhdq", XXXX},
-    {"vpunpckhqdq", XXXX},
-    {"vpunpckhwd", XXXX},
-    {"vpunpcklbw", XXXX},
-    {"vpunpckldq", XXXX},
-    {"vpunpcklqdq", XXXX},
-    {"vpunpcklwd", XXXX},
-    {"vpxor", XXXX},
-    {"vrcpps", XXXX},
-    {"vrcpss", XXXX},
-    {"vroundpd", XXXX},
-    {"vroundps", XXXX},
-    {"vroundsd", XXXX},
-    {"vroundss", XXXX},
-    {"vshufpd", XXXX},
-    {"vshufps", XXXX},
-    {"vsqrtpd", XXXX},
-    {"vsqrtps", XXXX},
-    {"vsqrtsd", XXXX},
-    {"vsqrtss", XXXX},
-    {"vstmxcsr", XXXX},
-    {"vsubpd", XXXX},
-    {"vsubps", XXXX},
-    {"vsubsd", XXXX},
-    {"vsubss", XXXX},
-    {"vucomisd", XXXX},
-    {"vucomiss", XXXX},
-    {"vunpckhpd", XXXX},
-    {"vunpckhps", XXXX},
-    {"vunpcklpd", XXXX},
-    {"vunpcklps", XXXX},
-    {"vxorpd", XXXX},
-    {"vxorps", XXXX},
-    {"vzeroall", XXXX},
-    {"vzeroupper", XXXX},
+    {"vexpandpd", Op_DstSrcSSE},
+    {"vexpandps", Op_DstSrcSSE},
+    {"vextractf128", Op_DstSrcSrcS},
+    {"vextractf32x4", Op_DstSrcSrcS},
+    {"vextractf32x8", Op_DstSrcSrcS},
+    {"vextractf64x2", Op_DstSrcSrcS},
+    {"vextractf64x4", Op_DstSrcSrcS},
+    {"vextracti128", Op_DstSrcSrcS},
+    {"vextracti32x4", Op_DstSrcSrcS},
+    {"vextracti32x8", Op_DstSrcSrcS},
+    {"vextracti64x2", Op_DstSrcSrcS},
+    {"vextracti64x4", Op_DstSrcSrcS},
+    {"vextractps", Op_DstSrcSrcS},
+    {"vfixupimmpd", Op_UpdSrcSrcImmS},
+    {"vfixupimmps", Op_UpdSrcSrcImmS},
+    {"vfixupimmsd", Op_UpdSrcSrcImmS},
+    {"vfixupimmss", Op_UpdSrcSrcImmS},
+    {"vfmadd132pd", Op_UpdSrcSrcS},
+    {"vfmadd132ps", Op_UpdSrcSrcS},
+    {"vfmadd132sd", Op_UpdSrcSrcS},
+    {"vfmadd132ss", Op_UpdSrcSrcS},
+    {"vfmadd213pd", Op_UpdSrcSrcS},
+    {"vfmadd213ps", Op_UpdSrcSrcS},
+    {"vfmadd213sd", Op_UpdSrcSrcS},
+    {"vfmadd213ss", Op_UpdSrcSrcS},
+    {"vfmadd231pd", Op_UpdSrcSrcS},
+    {"vfmadd231ps", Op_UpdSrcSrcS},
+    {"vfmadd231sd", Op_UpdSrcSrcS},
+    {"vfmadd231ss", Op_UpdSrcSrcS},
+    {"vfmaddsub132pd", Op_UpdSrcSrcS},
+    {"vfmaddsub132ps", Op_UpdSrcSrcS},
+    {"vfmaddsub213pd", Op_UpdSrcSrcS},
+    {"vfmaddsub213ps", Op_UpdSrcSrcS},
+    {"vfmaddsub231pd", Op_UpdSrcSrcS},
+    {"vfmaddsub231ps", Op_UpdSrcSrcS},
+    {"vfmsub132pd", Op_UpdSrcSrcS},
+    {"vfmsub132ps", Op_UpdSrcSrcS},
+    {"vfmsub132sd", Op_UpdSrcSrcS},
+    {"vfmsub132ss", Op_UpdSrcSrcS},
+    {"vfmsub213pd", Op_UpdSrcSrcS},
+    {"vfmsub213ps", Op_UpdSrcSrcS},
+    {"vfmsub213sd", Op_UpdSrcSrcS},
+    {"vfmsub213ss", Op_UpdSrcSrcS},
+    {"vfmsub231pd", Op_UpdSrcSrcS},
+    {"vfmsub231ps", Op_UpdSrcSrcS},
+    {"vfmsub231sd", Op_UpdSrcSrcS},
+    {"vfmsub231ss", Op_UpdSrcSrcS},
+    {"vfmsubadd132pd", Op_UpdSrcSrcS},
+    {"vfmsubadd132ps", Op_UpdSrcSrcS},
+    {"vfmsubadd213pd", Op_UpdSrcSrcS},
+    {"vfmsubadd213ps", Op_UpdSrcSrcS},
+    {"vfmsubadd231pd", Op_UpdSrcSrcS},
+    {"vfmsubadd231ps", Op_UpdSrcSrcS},
+    {"vfnmadd132pd", Op_UpdSrcSrcS},
+    {"vfnmadd132ps", Op_UpdSrcSrcS},
+    {"vfnmadd132sd", Op_UpdSrcSrcS},
+    {"vfnmadd132ss", Op_UpdSrcSrcS},
+    {"vfnmadd213pd", Op_UpdSrcSrcS},
+    {"vfnmadd213ps", Op_UpdSrcSrcS},
+    {"vfnmadd213sd", Op_UpdSrcSrcS},
+    {"vfnmadd213ss", Op_UpdSrcSrcS},
+    {"vfnmadd231pd", Op_UpdSrcSrcS},
+    {"vfnmadd231ps", Op_UpdSrcSrcS},
+    {"vfnmadd231sd", Op_UpdSrcSrcS},
+    {"vfnmadd231ss", Op_UpdSrcSrcS},
+    {"vfnmsub132pd", Op_UpdSrcSrcS},
+    {"vfnmsub132ps", Op_UpdSrcSrcS},
+    {"vfnmsub132sd", Op_UpdSrcSrcS},
+    {"vfnmsub132ss", Op_UpdSrcSrcS},
+    {"vfnmsub213pd", Op_UpdSrcSrcS},
+    {"vfnmsub213ps", Op_UpdSrcSrcS},
+    {"vfnmsub213sd", Op_UpdSrcSrcS},
+    {"vfnmsub213ss", Op_UpdSrcSrcS},
+    {"vfnmsub231pd", Op_UpdSrcSrcS},
+    {"vfnmsub231ps", Op_UpdSrcSrcS},
+    {"vfnmsub231sd", Op_UpdSrcSrcS},
+    {"vfnmsub231ss", Op_UpdSrcSrcS},
+    {"vfpclasspd", Op_DstSrcSrcS},
+    {"vfpclassps", Op_DstSrcSrcS},
+    {"vfpclasssd", Op_DstSrcSrcS},
+    {"vfpclassss", Op_DstSrcSrcS},
+    {"vgatherdpd", Op_GatherV},
+    {"vgatherdps", Op_GatherV},
+    {"vgatherqpd", Op_GatherV},
+    {"vgatherqps", Op_GatherV},
+    {"vgetexppd", Op_DstSrcSSE},
+    {"vgetexpps", Op_DstSrcSSE},
+    {"vgetexpsd", Op_DstSrcSrcS},
+    {"vgetexpss", Op_DstSrcSrcS},
+    {"vgetmantpd", Op_DstSrcSrcS},
+    {"vgetmantps", Op_DstSrcSrcS},
+    {"vgetmantsd", Op_DstSrcSrcSrcS},
+    {"vgetmantss", Op_DstSrcSrcSrcS},
+    {"vhaddpd", Op_DstSrcSrcS},
+    {"vhaddps", Op_DstSrcSrcS},
+    {"vhsubpd", Op_DstSrcSrcS},
+    {"vhsubps", Op_DstSrcSrcS},
+    {"vinsertf128", Op_DstSrcSrcSrcS},
+    {"vinsertf32x4", Op_DstSrcSrcSrcS},
+    {"vinsertf32x8", Op_DstSrcSrcSrcS},
+    {"vinsertf64x2", Op_DstSrcSrcSrcS},
+    {"vinsertf64x4", Op_DstSrcSrcSrcS},
+    {"vinserti128", Op_DstSrcSrcSrcS},
+    {"vinserti32x4", Op_DstSrcSrcSrcS},
+    {"vinserti32x8", Op_DstSrcSrcSrcS},
+    {"vinserti64x2", Op_DstSrcSrcSrcS},
+    {"vinserti64x4", Op_DstSrcSrcSrcS},
+    {"vinsertps", Op_DstSrcSrcSrcS},
+    {"vlddqu", Op_DstSrcSSE},
+    {"vldmxcsr", Op_SrcMemNT},
+    {"vmaskmovdqu", Op_SrcSrcMMX},
+    {"vmaskmovpd", Op_DstSrcSrcS},
+    {"vmaskmovps", Op_DstSrcSrcS},
+    {"vmaxpd", Op_DstSrcSrcS},
+    {"vmaxps", Op_DstSrcSrcS},
+    {"vmaxsd", Op_DstSrcSrcS},
+    {"vmaxss", Op_DstSrcSrcS},
+    {"vminpd", Op_DstSrcSrcS},
+    {"vminps", Op_DstSrcSrcS},
+    {"vminsd", Op_DstSrcSrcS},
+    {"vminss", Op_DstSrcSrcS},
+    {"vmovapd", Op_DstSrcSSE},
+    {"vmovaps", Op_DstSrcSSE},
+    {"vmovd", Op_DstSrcNT},
+    {"vmovddup", Op_DstSrcSSE},
+    {"vmovdqa", Op_DstSrcSSE},
+    {"vmovdqa32", Op_DstSrcSSE},
+    {"vmovdqa64", Op_DstSrcSSE},
+    {"vmovdqu", Op_DstSrcSSE},
+    {"vmovdqu16", Op_DstSrcSSE},
+    {"vmovdqu32", Op_DstSrcSSE},
+    {"vmovdqu64", Op_DstSrcSSE},
+    {"vmovdqu8", Op_DstSrcSSE},
+    {"vmovhlps", Op_DstSrcSrcS},
+    {"vmovhpd", Op_DstSrcAVX},
+    {"vmovhps", Op_DstSrcAVX},
+    {"vmovlhps", Op_DstSrcSrcS},
+    {"vmovlpd", Op_DstSrcAVX},
+    {"vmovlps", Op_DstSrcAVX},
+    {"vmovmskpd", Op_DstSrcSSE},
+    {"vmovmskps", Op_DstSrcSSE},
+    {"vmovntdq", Op_DstSrcSSE},
+    {"vmovntdqa", Op_DstSrcSSE},
+    {"vmovntpd", Op_DstSrcSSE},
+    {"vmovntps", Op_DstSrcSSE},
+    {"vmovq", Op_DstSrcNT},
+    {"vmovsd", Op_DstSrcAVX},
+    {"vmovshdup", Op_DstSrcSSE},
+    {"vmovsldup", Op_DstSrcSSE},
+    {"vmovss", Op_DstSrcAVX},
+    {"vmovupd", Op_DstSrcSSE},
+    {"vmovups", Op_DstSrcSSE},
+    {"vmpsadbw", Op_DstSrcSrcSrcS},
+    {"vmulpd", Op_DstSrcSrcS},
+    {"vmulps", Op_DstSrcSrcS},
+    {"vmulsd", Op_DstSrcSrcS},
+    {"vmulss", Op_DstSrcSrcS},
+    {"vorpd", Op_DstSrcSrcS},
+    {"vorps", Op_DstSrcSrcS},
+    {"vpabsb", Op_DstSrcSSE},
+    {"vpabsd", Op_DstSrcSSE},
+    {"vpabsq", Op_DstSrcSSE},
+    {"vpabsw", Op_DstSrcSSE},
+    {"vpackssdw", Op_DstSrcSrcS},
+    {"vpacksswb", Op_DstSrcSrcS},
+    {"vpackusdw", Op_DstSrcSrcS},
+    {"vpackuswb", Op_DstSrcSrcS},
+    {"vpaddb", Op_DstSrcSrcS},
+    {"vpaddd", Op_DstSrcSrcS},
+    {"vpaddq", Op_DstSrcSrcS},
+    {"vpaddsb", Op_DstSrcSrcS},
+    {"vpaddsw", Op_DstSrcSrcS},
+    {"vpaddusb", Op_DstSrcSrcS},
+    {"vpaddusw", Op_DstSrcSrcS},
+    {"vpaddw", Op_DstSrcSrcS},
+    {"vpalignr", Op_DstSrcSrcSrcS},
+    {"vpand", Op_DstSrcSrcS},
+    {"vpandd", Op_DstSrcSrcS},
+    {"vpandn", Op_DstSrcSrcS},
+    {"vpandnd", Op_DstSrcSrcS},
+    {"vpandnq", Op_DstSrcSrcS},
+    {"vpandq", Op_DstSrcSrcS},
+    {"vpavgb", Op_DstSrcSrcS},
+    {"vpavgw", Op_DstSrcSrcS},
+    {"vpblendd", Op_DstSrcSrcSrcS},
+    {"vpblendmb", Op_DstSrcSrcS},
+    {"vpblendmd", Op_DstSrcSrcS},
+    {"vpblendmq", Op_DstSrcSrcS},
+    {"vpblendmw", Op_DstSrcSrcS},
+    {"vpblendvb", Op_DstSrcSrcSrcS},
+    {"vpblendw", Op_DstSrcSrcSrcS},
+    {"vpbroadcastb", Op_DstSrcSSE},
+    {"vpbroadcastd", Op_DstSrcSSE},
+    {"vpbroadcastq", Op_DstSrcSSE},
+    {"vpbroadcastw", Op_DstSrcSSE},
+    {"vpclmulqdq", Op_DstSrcSrcSrcS},
+    {"vpcmpb", Op_DstSrcSrcSrcS},
+    {"vpcmpd", Op_DstSrcSrcSrcS},
+    {"vpcmpeqb", Op_DstSrcSrcS},
+    {"vpcmpeqd", Op_DstSrcSrcS},
+    {"vpcmpeqq", Op_DstSrcSrcS},
+    {"vpcmpeqw", Op_DstSrcSrcS},
+    {"vpcmpestri", Op_pcmpstri},
+    {"vpcmpestrm", Op_pcmpstrm},
+    {"vpcmpgtb", Op_DstSrcSrcS},
+    {"vpcmpgtd", Op_DstSrcSrcS},
+    {"vpcmpgtq", Op_DstSrcSrcS},
+    {"vpcmpgtw", Op_DstSrcSrcS},
+    {"vpcmpistri", Op_pcmpstri},
+    {"vpcmpistrm", Op_pcmpstrm},
+    {"vpcmpq", Op_DstSrcSrcSrcS},
+    {"vpcmpub", Op_DstSrcSrcSrcS},
+    {"vpcmpud", Op_DstSrcSrcSrcS},
+    {"vpcmpuq", Op_DstSrcSrcSrcS},
+    {"vpcmpuw", Op_DstSrcSrcSrcS},
+    {"vpcmpw", Op_DstSrcSrcSrcS},
+    {"vpcompressd", Op_DstSrcSSE},
+    {"vpcompressq", Op_DstSrcSSE},
+    {"vperm2f128", Op_DstSrcSrcSrcS},
+    {"vperm2i128", Op_DstSrcSrcSrcS},
+    {"vpermb", Op_DstSrcSrcS},
+    {"vpermd", Op_DstSrcSrcS},
+    {"vpermi2b", Op_UpdSrcSrcS},
+    {"vpermi2d", Op_UpdSrcSrcS},
+    {"vpermi2pd", Op_UpdSrcSrcS},
+    {"vpermi2ps", Op_UpdSrcSrcS},
+    {"vpermi2q", Op_UpdSrcSrcS},
+    {"vpermi2w", Op_UpdSrcSrcS},
+    {"vpermilpd", Op_DstSrcSrcS},
+    {"vpermilps", Op_DstSrcSrcS},
+    {"vpermpd", Op_DstSrcSrcS},
+    {"vpermps", Op_DstSrcSrcS},
+    {"vpermq", Op_DstSrcSrcS},
+    {"vpermt2b", Op_UpdSrcSrcS},
+    {"vpermt2d", Op_UpdSrcSrcS},
+    {"vpermt2pd", Op_UpdSrcSrcS},
+    {"vpermt2ps", Op_UpdSrcSrcS},
+    {"vpermt2q", Op_UpdSrcSrcS},
+    {"vpermt2w", Op_UpdSrcSrcS},
+    {"vpermw", Op_DstSrcSrcS},
+    {"vpexpandd", Op_DstSrcSSE},
+    {"vpexpandq", Op_DstSrcSSE},
+    {"vpextrb", Op_DstSrcSrcS},
+    {"vpextrd", Op_DstSrcSrcS},
+#ifdef ASM_X86_64
+    {"vpextrq", Op_DstSrcSrcS},
+#endif
+    {"vpextrw", Op_DstSrcSrcS},
+    {"vpgatherdd", Op_GatherV},
+    {"vpgatherdq", Op_GatherV},
+    {"vpgatherqd", Op_GatherV},
+    {"vpgatherqq", Op_GatherV},
+    {"vphaddd", Op_DstSrcSrcS},
+    {"vphaddsw", Op_DstSrcSrcS},
+    {"vphaddw", Op_DstSrcSrcS},
+    {"vphminposuw", Op_DstSrcSSE},
+    {"vphsubd", Op_DstSrcSrcS},
+    {"vphsubsw", Op_DstSrcSrcS},
+    {"vphsubw", Op_DstSrcSrcS},
+    {"vpinsrb", Op_DstSrcSrcSrcS},
+    {"vpinsrd", Op_DstSrcSrcSrcS},
+#ifdef ASM_X86_64
+    {"vpinsrq", Op_DstSrcSrcSrcS},
 #endif
+    {"vpinsrw", Op_DstSrcSrcSrcS},
+    {"vpmaddubsw", Op_DstSrcSrcS},
+    {"vpmaddwd", Op_DstSrcSrcS},
+    {"vpmaskmovd", Op_DstSrcSrcS},
+    {"vpmaskmovq", Op_DstSrcSrcS},
+    {"vpmaxsb", Op_DstSrcSrcS},
+    {"vpmaxsd", Op_DstSrcSrcS},
+    {"vpmaxsq", Op_DstSrcSrcS},
+    {"vpmaxsw", Op_DstSrcSrcS},
+    {"vpmaxub", Op_DstSrcSrcS},
+    {"vpmaxud", Op_DstSrcSrcS},
+    {"vpmaxuq", Op_DstSrcSrcS},
+    {"vpmaxuw", Op_DstSrcSrcS},
+    {"vpminsb", Op_DstSrcSrcS},
+    {"vpminsd", Op_DstSrcSrcS},
+    {"vpminsq", Op_DstSrcSrcS},
+    {"vpminsw", Op_DstSrcSrcS},
+    {"vpminub", Op_DstSrcSrcS},
+    {"vpminud", Op_DstSrcSrcS},
+    {"vpminuq", Op_DstSrcSrcS},
+    {"vpminuw", Op_DstSrcSrcS},
+    {"vpmovb2m", Op_DstSrcSSE},
+    {"vpmovd2m", Op_DstSrcSSE},
+    {"vpmovdb", Op_DstSrcSSE},
+    {"vpmovdw", Op_DstSrcSSE},
+    {"vpmovm2b", Op_DstSrcSSE},
+    {"vpmovm2d", Op_DstSrcSSE},
+    {"vpmovm2q", Op_DstSrcSSE},
+    {"vpmovm2w", Op_DstSrcSSE},
+    {"vpmovmskb", Op_DstSrcSSE},
+    {"vpmovq2m", Op_DstSrcSSE},
+    {"vpmovqb", Op_DstSrcSSE},
+    {"vpmovqd", Op_DstSrcSSE},
+    {"vpmovqw", Op_DstSrcSSE},
+    {"vpmovsdb", Op_DstSrcSSE},
+    {"vpmovsdw", Op_DstSrcSSE},
+    {"vpmovsqb", Op_DstSrcSSE},
+    {"vpmovsqd", Op_DstSrcSSE},
+    {"vpmovsqw", Op_DstSrcSSE},
+    {"vpmovswb", Op_DstSrcSSE},
+    {"vpmovsxbd", Op_DstSrcSSE},
+    {"vpmovsxbq", Op_DstSrcSSE},
+    {"vpmovsxbw", Op_DstSrcSSE},
+    {"vpmovsxdq", Op_DstSrcSSE},
+    {"vpmovsxwd", Op_DstSrcSSE},
+    {"vpmovsxwq", Op_DstSrcSSE},
+    {"vpmovusdb", Op_DstSrcSSE},
+    {"vpmovusdw", Op_DstSrcSSE},
+    {"vpmovusqb", Op_DstSrcSSE},
+    {"vpmovusqd", Op_DstSrcSSE},
+    {"vpmovusqw", Op_DstSrcSSE},
+    {"vpmovuswb", Op_DstSrcSSE},
+    {"vpmovw2m", Op_DstSrcSSE},
+    {"vpmovwb", Op_DstSrcSSE},
+    {"vpmovzxbd", Op_DstSrcSSE},
+    {"vpmovzxbq", Op_DstSrcSSE},
+    {"vpmovzxbw", Op_DstSrcSSE},
+    {"vpmovzxdq", Op_DstSrcSSE},
+    {"vpmovzxwd", Op_DstSrcSSE},
+    {"vpmovzxwq", Op_DstSrcSSE},
+    {"vpmuldq", Op_DstSrcSrcS},
+    {"vpmulhrsw", Op_DstSrcSrcS},
+    {"vpmulhuw", Op_DstSrcSrcS},
+    {"vpmulhw", Op_DstSrcSrcS},
+    {"vpmulld", Op_DstSrcSrcS},
+    {"vpmullq", Op_DstSrcSrcS},
+    {"vpmullw", Op_DstSrcSrcS},
+    {"vpmuludq", Op_DstSrcSrcS},
+    {"vpor", Op_DstSrcSrcS},
+    {"vpord", Op_DstSrcSrcS},
+    {"vporq", Op_DstSrcSrcS},
+    {"vprold", Op_DstSrcSrcS},
+    {"vprolq", Op_DstSrcSrcS},
+    {"vprolvd", Op_DstSrcSrcS},
+    {"vprolvq", Op_DstSrcSrcS},
+    {"vprord", Op_DstSrcSrcS},
+    {"vprorq", Op_DstSrcSrcS},
+    {"vprorvd", Op_DstSrcSrcS},
+    {"vprorvq", Op_DstSrcSrcS},
+    {"vpsadbw", Op_DstSrcSrcS},
+    {"vpscatterdd", Op_ScatterK},
+    {"vpscatterdq", Op_ScatterK},
+    {"vpscatterqd", Op_ScatterK},
+    {"vpscatterqq", Op_ScatterK},
+    {"vpshldw", Op_DstSrcSrcS},
+    {"vpshrdw", Op_DstSrcSrcS},
+    {"vpshufb", Op_DstSrcSrcS},
+    {"vpshufd", Op_DstSrcSrcS},
+    {"vpshufhw", Op_DstSrcSrcS},
+    {"vpshuflw", Op_DstSrcSrcS},
+    {"vpsignb", Op_DstSrcSrcS},
+    {"vpsignd", Op_DstSrcSrcS},
+    {"vpsignw", Op_DstSrcSrcS},
+    {"vpslld", Op_DstSrcSrcS},
+    {"vpslldq", Op_DstSrcSrcS},
+    {"vpsllq", Op_DstSrcSrcS},
+    {"vpsllvd", Op_DstSrcSrcS},
+    {"vpsllvq", Op_DstSrcSrcS},
+    {"vpsllvw", Op_DstSrcSrcS},
+    {"vpsllw", Op_DstSrcSrcS},
+    {"vpsrad", Op_DstSrcSrcS},
+    {"vpsraq", Op_DstSrcSrcS},
+    {"vpsravd", Op_DstSrcSrcS},
+    {"vpsravq", Op_DstSrcSrcS},
+    {"vpsravw", Op_DstSrcSrcS},
+    {"vpsraw", Op_DstSrcSrcS},
+    {"vpsrld", Op_DstSrcSrcS},
+    {"vpsrldq", Op_DstSrcSrcS},
+    {"vpsrlq", Op_DstSrcSrcS},
+    {"vpsrlvd", Op_DstSrcSrcS},
+    {"vpsrlvq", Op_DstSrcSrcS},
+    {"vpsrlvw", Op_DstSrcSrcS},
+    {"vpsrlw", Op_DstSrcSrcS},
+    {"vpsubb", Op_DstSrcSrcS},
+    {"vpsubd", Op_DstSrcSrcS},
+    {"vpsubq", Op_DstSrcSrcS},
+    {"vpsubsb", Op_DstSrcSrcS},
+    {"vpsubsw", Op_DstSrcSrcS},
+    {"vpsubusb", Op_DstSrcSrcS},
+    {"vpsubusw", Op_DstSrcSrcS},
+    {"vpsubw", Op_DstSrcSrcS},
+    {"vpternlogd", Op_UpdSrcSrcImmS},
+    {"vpternlogq", Op_UpdSrcSrcImmS},
+    {"vptest", Op_SrcSrcSSEF},
+    {"vptestmb", Op_DstSrcSrcS},
+    {"vptestmd", Op_DstSrcSrcS},
+    {"vptestmq", Op_DstSrcSrcS},
+    {"vptestmw", Op_DstSrcSrcS},
+    {"vptestnmb", Op_DstSrcSrcS},
+    {"vptestnmd", Op_DstSrcSrcS},
+    {"vptestnmq", Op_DstSrcSrcS},
+    {"vptestnmw", Op_DstSrcSrcS},
+    {"vpunpckhbw", Op_DstSrcSrcS},
+    {"vpunpckhdq", Op_DstSrcSrcS},
+    {"vpunpckhqdq", Op_DstSrcSrcS},
+    {"vpunpckhwd", Op_DstSrcSrcS},
+    {"vpunpcklbw", Op_DstSrcSrcS},
+    {"vpunpckldq", Op_DstSrcSrcS},
+    {"vpunpcklqdq", Op_DstSrcSrcS},
+    {"vpunpcklwd", Op_DstSrcSrcS},
+    {"vpxor", Op_DstSrcSrcS},
+    {"vpxord", Op_DstSrcSrcS},
+    {"vpxorq", Op_DstSrcSrcS},
+    {"vrangepd", Op_DstSrcSrcSrcS},
+    {"vrangeps", Op_DstSrcSrcSrcS},
+    {"vrangesd", Op_DstSrcSrcSrcS},
+    {"vrangess", Op_DstSrcSrcSrcS},
+    {"vrcp14pd", Op_DstSrcSSE},
+    {"vrcp14ps", Op_DstSrcSSE},
+    {"vrcp14sd", Op_DstSrcSrcS},
+    {"vrcp14ss", Op_DstSrcSrcS},
+    {"vrcpps", Op_DstSrcSSE},
+    {"vrcpss", Op_DstSrcSrcS},
+    {"vreducepd", Op_DstSrcSrcS},
+    {"vreduceps", Op_DstSrcSrcS},
+    {"vreducesd", Op_DstSrcSrcSrcS},
+    {"vreducess", Op_DstSrcSrcSrcS},
+    {"vrndscalepd", Op_DstSrcSrcS},
+    {"vrndscaleps", Op_DstSrcSrcS},
+    {"vrndscalesd", Op_DstSrcSrcSrcS},
+    {"vrndscaless", Op_DstSrcSrcSrcS},
+    {"vroundpd", Op_DstSrcSrcS},
+    {"vroundps", Op_DstSrcSrcS},
+    {"vroundsd", Op_DstSrcSrcSrcS},
+    {"vroundss", Op_DstSrcSrcSrcS},
+    {"vrsqrt14pd", Op_DstSrcSSE},
+    {"vrsqrt14ps", Op_DstSrcSSE},
+    {"vrsqrt14sd", Op_DstSrcSrcS},
+    {"vrsqrt14ss", Op_DstSrcSrcS},
+    {"vrsqrtps", Op_DstSrcSSE},
+    {"vrsqrtss", Op_DstSrcSrcS},
+    {"vscalefpd", Op_DstSrcSrcS},
+    {"vscalefps", Op_DstSrcSrcS},
+    {"vscalefsd", Op_DstSrcSrcS},
+    {"vscalefss", Op_DstSrcSrcS},
+    {"vscatterdpd", Op_ScatterK},
+    {"vscatterdps", Op_ScatterK},
+    {"vscatterqpd", Op_ScatterK},
+    {"vscatterqps", Op_ScatterK},
+    {"vshuff32x4", Op_DstSrcSrcSrcS},
+    {"vshuff64x2", Op_DstSrcSrcSrcS},
+    {"vshufi32x4", Op_DstSrcSrcSrcS},
+    {"vshufi64x2", Op_DstSrcSrcSrcS},
+    {"vshufpd", Op_DstSrcSrcSrcS},
+    {"vshufps", Op_DstSrcSrcSrcS},
+    {"vsqrtpd", Op_DstSrcSSE},
+    {"vsqrtps", Op_DstSrcSSE},
+    {"vsqrtsd", Op_DstSrcSrcS},
+    {"vsqrtss", Op_DstSrcSrcS},
+    {"vstmxcsr", Op_DstMemNT},
+    {"vsubpd", Op_DstSrcSrcS},
+    {"vsubps", Op_DstSrcSrcS},
+    {"vsubsd", Op_DstSrcSrcS},
+    {"vsubss", Op_DstSrcSrcS},
+    {"vtestpd", Op_SrcSrcSSEF},
+    {"vtestps", Op_SrcSrcSSEF},
+    {"vucomisd", Op_SrcSrcSSEF},
+    {"vucomiss", Op_SrcSrcSSEF},
+    {"vunpckhpd", Op_DstSrcSrcS},
+    {"vunpckhps", Op_DstSrcSrcS},
+    {"vunpcklpd", Op_DstSrcSrcS},
+    {"vunpcklps", Op_DstSrcSrcS},
+    {"vxorpd", Op_DstSrcSrcS},
+    {"vxorps", Op_DstSrcSrcS},
+    {"vzeroall", Op_vzero},
+    {"vzeroupper", Op_vzero},
 #ifndef ASM_X86_64
     {"wait", Op_0},
 #endif
@@ -2029,9 +2563,14 @@ struct AsmProcessor {
     OperandClass cls;
     PtrType dataSize;
     PtrType dataSizeHint; // DMD can use the type of a referenced variable
+
+    // AVX-512 decorators
+    unsigned char maskReg; // {K1}-{K7} (0 if unmasked)
+    int zeroMasking;       // {z}
+    int broadcast;         // {1to<N>} (0 if no embedded broadcast)
   } Operand;
 
-  static const unsigned Max_Operands = 3;
+  static const unsigned Max_Operands = 4;
 
   AsmStatement *stmt;
   Scope *sc;
@@ -2228,6 +2767,7 @@ struct AsmProcessor {
         operand->reg = operand->baseReg = operand->indexReg =
             operand->segmentPrefix = Reg_Invalid;
         parseOperand();
+        parseDecorators();
         operand_i++;
       } else {
         stmt->error("too many operands for instruction");
@@ -2256,8 +2796,56 @@ struct AsmProcessor {
     }
   }
 
+  // Parses the AVX-512 decorators following an operand: an opmask ({K1}),
+  // zeroing-masking ({z}) and embedded broadcasts ({1to16}).
+  void parseDecorators() {
+    while (token->value == TOKlcurly) {
+      nextToken();
+      if (token->value == TOKidentifier &&
+          (strcmp(token->ident->string, "z") == 0 ||
+           strcmp(token->ident->string, "Z") == 0)) {
+        operand->zeroMasking = 1;
+        nextToken();
+      } else if (token->value == TOKidentifier) {
+        for (int i = 1; i < 8; i++) {
+          if (token->ident == regInfo[Reg_K0 + i].ident) {
+            operand->maskReg = i;
+          }
+        }
+        if (!operand->maskReg) {
+          stmt->error("expected opmask register K1-K7, not '%s'",
+                      token->toChars());
+        }
+        nextToken();
+      } else if ((token->value == TOKint32v || token->value == TOKuns32v) &&
+                 token->uns64value == 1 &&
+                 peekToken()->value == TOKidentifier &&
+                 strncmp(peekToken()->ident->string, "to", 2) == 0) {
+        nextToken();
+        operand->broadcast = atoi(token->ident->string + 2);
+        if (operand->broadcast != 2 && operand->broadcast != 4 &&
+            operand->broadcast != 8 && operand->broadcast != 16) {
+          stmt->error("invalid embedded broadcast '{1%s}'",
+                      token->ident->string);
+        }
+        nextToken();
+      } else {
+        stmt->error("invalid operand decorator '%s'", token->toChars());
+      }
+
+      if (token->value != TOKrcurly) {
+        stmt->error("expected '}'");
+        return;
+      }
+      nextToken();
+    }
+  }
+
   void setAsmCode() {
     auto asmcode = new AsmCode(N_Regs);
+    // Directives and raw data are opaque to the effect analysis.
+    asmcode->hasSideEffects = 1;
+    asmcode->usesStackFrame = 1;
     asmcode->insnTemplate = insnTemplate.str();
     Logger::cout() << "insnTemplate = " << asmcode->insnTemplate << '\n';
     stmt->asmcode = (code *)asmcode;
@@ -2486,6 +3074,25 @@ struct AsmProcessor {
 
   void writeReg(Reg reg) { insnTemplate << "%" << regInfo[reg].gccName; }
 
+  void writeDecorators(Operand *operand, AsmCode *asmcode) {
+    if (operand->broadcast) {
+      insnTemplate << "{1to" << operand->broadcast << '}';
+    }
+    if (operand->maskReg) {
+      Reg mask = static_cast<Reg>(Reg_K0 + operand->maskReg);
+      insnTemplate << '{';
+      writeReg(mask);
+      insnTemplate << '}';
+      // gathers and scatters clear the mask as they make progress
+      if (op == Op_GatherK || op == Op_ScatterK) {
+        asmcode->regs[mask] = true;
+      }
+    }
+    if (operand->zeroMasking) {
+      insnTemplate << "{z}";
+    }
+  }
+
   bool opTakesLabel() {
     switch (op) {
     case Op_Branch:
@@ -2497,6 +3104,176 @@ struct AsmProcessor {
     }
   }
 
+  // Whether the instruction does more than writing its register and memory
+  // operands and implicit clobbers, i.e., whether the optimizer must neither
+  // remove, duplicate nor reorder it.
+  bool hasSideEffects() {
+    switch (op) {
+    case Op_Branch:
+    case Op_CBranch:
+    case Op_Loop:
+    case Op_0:     // lock/rep prefixes, fences, hlt, emms, ...
+    case Op_Flags: // cld, cli, ...
+    case Op_SrcImm:
+    case Op_SrcMemNT:
+    case Op_SrcMemNTF:
+    case Op_DstMemNT:
+    case Op_DstRMWNT:
+    case Op_SrcRMWNT:
+    case Op_SizedStack:
+    case Op_bound:
+    case Op_cmps:
+    case Op_cmpsd:
+    case Op_cmpsX:
+    case Op_cmpxchg:
+#ifdef ASM_X86_64
+    case Op_cmpxchg16b:
+#endif
+    case Op_cmpxchg8b:
+    case Op_cpuid:
+    case Op_enter:
+    case Op_fdisi:
+    case Op_feni:
+    case Op_fsetpm:
+    case Op_fXstsw:
+    case Op_in:
+    case Op_ins:
+    case Op_insX:
+    case Op_iret:
+    case Op_iretd:
+#ifdef ASM_X86_64
+    case Op_iretq:
+#endif
+    case Op_lods:
+    case Op_lodsX:
+    case Op_movs:
+    case Op_movsd:
+    case Op_movsX:
+    case Op_out:
+    case Op_outs:
+    case Op_outsX:
+    case Op_push:
+    case Op_ret:
+    case Op_retf:
+    case Op_scas:
+    case Op_scasX:
+    case Op_stos:
+    case Op_stosX:
+    case Op_vzero:
+    case Op_xgetbv:
+    case Op_xlat:
+      return true;
+    default:
+      break;
+    }
+
+    // The x87 register stack may be left unbalanced for a later block.
+    if (opInfo->implicitClobbers & Clb_ST) {
+      return true;
+    }
+
+    static const char *const impureMnemonics[] = {
+        "pause", "pop", "rdmsr", "rdpmc", "rdtsc", "xlatb",
+    };
+    for (auto m : impureMnemonics) {
+      if (strcmp(opIdent->string, m) == 0) {
+        return true;
+      }
+    }
+
+    // xchg with a memory operand is implicitly locked.
+    if (op == Op_UpdUpd) {
+      return operands[0].cls == Opr_Mem || operands[1].cls == Opr_Mem;
+    }
+
+    return false;
+  }
+
+  // Whether the instruction reads the flags set by an earlier instruction.
+  bool readsFlags() {
+    if (op == Op_CBranch) {
+      return true;
+    }
+    const llvm::StringRef mnemonic = opIdent->string;
+    static const char *const prefixes[] = {"adc", "cmov", "fcmov", "rcl",
+                                           "rcr", "sbb",  "set"};
+    for (auto prefix : prefixes) {
+      if (mnemonic.startswith(prefix)) {
+        return true;
+      }
+    }
+    return mnemonic == "cmc" || mnemonic == "lahf" || mnemonic == "into" ||
+           mnemonic.startswith("pushf");
+  }
+
+  static void readReg(Reg reg, AsmCode *asmcode) {
+    if (reg == Reg_Invalid) {
+      return;
+    }
+    const Reg base = static_cast<Reg>(regInfo[reg].baseReg);
+    if (base != Reg_Invalid) {
+      asmcode->regsRead[base] = true;
+    }
+  }
+
+  static bool isFrameReg(Reg reg) {
+    if (reg == Reg_Invalid) {
+      return false;
+    }
+    switch (regInfo[reg].baseReg) {
+    case Reg_EBP:
+    case Reg_ESP:
+#ifdef ASM_X86_64
+    case Reg_RBP:
+    case Reg_RSP:
+    case Reg_BPL:
+    case Reg_SPL:
+#endif
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  // Whether the instruction refers to the stack frame or to labels of the
+  // enclosing function, so that its code can't be inlined elsewhere.
+  bool usesStackFrame(int nOperands, AsmCode *asmcode) {
+    if (opTakesLabel() || (opInfo->implicitClobbers & Clb_SP)) {
+      return true;
+    }
+    switch (op) {
+    case Op_enter:
+    case Op_ret:
+    case Op_retf:
+    case Op_iret:
+    case Op_iretd:
+#ifdef ASM_X86_64
+    case Op_iretq:
+#endif
+      return true;
+    default:
+      break;
+    }
+    if (strcmp(opIdent->string, "pop") == 0 ||
+        strcmp(opIdent->string, "leave") == 0) {
+      return true;
+    }
+
+    for (int i = 0; i < nOperands; i++) {
+      const Operand &o = operands[i];
+      if ((o.cls == Opr_Reg && isFrameReg(o.reg)) || isFrameReg(o.baseReg) ||
+          isFrameReg(o.indexReg)) {
+        return true;
+      }
+    }
+    for (const auto &arg : asmcode->args) {
+      if (arg.type == Arg_FrameRelative || arg.type == Arg_LocalSize) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   bool getTypeSuffix(TypeNeeded needed, PtrType ptrtype,
                      std::string &type_suffix) {
     switch (needed) {
@@ -2824,6 +3601,24 @@ struct AsmProcessor {
       asmcode->regs[Reg_ECX] = true;
       asmcode->regs[Reg_EDX] = true;
     }
+    if (op == Op_pcmpstrm) {
+      asmcode->regs[Reg_XMM0] = true;
+    }
+    if (op == Op_vzero) {
+      for (int i = Reg_YMM0; i <= Reg_YMM7; i++) {
+        asmcode->regs[i] = true;
+      }
+#ifdef ASM_X86_64
+      for (int i = Reg_YMM8; i <= Reg_YMM15; i++) {
+        asmcode->regs[i] = true;
+      }
+#endif
+    }
+
+    // Implicitly clobbered registers are conservatively assumed to be read as
+    // well (e.g., by mul/div). Only a few instructions read the flags though.
+    asmcode->regsRead = asmcode->regs;
+    asmcode->regsRead[Reg_EFLAGS] = readsFlags();
 
     insnTemplate << ' ';
     for (int i__ = 0; i__ < nOperands; i__++) {
@@ -2906,16 +3701,26 @@ struct AsmProcessor {
             asmcode->regs[clbr_reg] = true;
           }
         }
+        // Writes to 8/16-bit registers merge with the rest of the register.
+        if (!(opInfo->operands[i] & Opr_Dest) ||
+            (opInfo->operands[i] & Opr_Update) == Opr_Update ||
+            regInfo[operand->reg].size < 4) {
+          readReg(operand->reg, asmcode);
+        }
         if (opTakesLabel()) {
           insnTemplate << '*';
         }
         writeReg(operand->reg);
+        writeDecorators(operand, asmcode);
         /*
         insnTemplate << "%";
         insnTemplate << regInfo[operand->reg].name;
         */
         break;
       case Opr_Mem:
+        readReg(operand->baseReg, asmcode);
+        readReg(operand->indexReg, asmcode);
+
         // better: use output operands for simple variable references
         if ((opInfo->operands[i] & Opr_Update) == Opr_Update) {
           mode = Mode_Update;
@@ -2925,6 +3730,10 @@ struct AsmProcessor {
           mode = Mode_Input;
         }
 
+        if (mode != Mode_Output) {
+          asmcode->readsMemory = 1;
+        }
+
         use_star = opTakesLabel();
 
         if (Logger::enabled()) {
@@ -3083,12 +3892,20 @@ struct AsmProcessor {
             asmcode->clobbersMemory = 1;
           }
         }
+        writeDecorators(operand, asmcode);
         break;
       case Opr_Invalid:
         return false;
       }
     }
 
+    if (hasSideEffects()) {
+      asmcode->hasSideEffects = 1;
+    }
+    if (usesStackFrame(nOperands, asmcode)) {
+      asmcode->usesStackFrame = 1;
+    }
+
     asmcode->insnTemplate = insnTemplate.str();
     Logger::cout() << "insnTemplate = " << asmcode->insnTemplate << '\n';
     return true;
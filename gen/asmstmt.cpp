@@ -9,6 +9,7 @@
 
 #include "gen/llvm.h"
 #include "llvm/IR/InlineAsm.h"
+#include "llvm/Support/CommandLine.h"
 
 //#include "d-gcc-includes.h"
 //#include "total.h"
@@ -35,6 +36,13 @@
 #include "gen/functions.h"
 #include "ir/irfunction.h"
 
+static llvm::cl::opt<bool> preciseAsm(
+    "precise-asm",
+    llvm::cl::desc("Derive the side effects of DMD-style asm blocks from their "
+                   "instructions, so that pure ones can be inlined and "
+                   "optimized"),
+    llvm::cl::ZeroOrMore);
+
 typedef enum {
   Arg_Integer,
   Arg_Pointer,
@@ -61,12 +69,26 @@ struct AsmCode {
   std::string insnTemplate;
   std::vector<AsmArg> args;
   std::vector<bool> regs;
+  // The registers read by the instruction (incl. address registers).
+  std::vector<bool> regsRead;
   unsigned dollarLabel;
   int clobbersMemory;
+  // Set if a memory operand is read.
+  int readsMemory;
+  // Set if the instruction has effects (or dependencies) beyond its register
+  // and memory operands, e.g., control flow, I/O or system state.
+  int hasSideEffects;
+  // Set if the instruction depends on the enclosing function's stack frame or
+  // control flow, which rules out inlining the function.
+  int usesStackFrame;
   explicit AsmCode(int n_regs) {
     regs.resize(n_regs, false);
+    regsRead.resize(n_regs, false);
     dollarLabel = 0;
     clobbersMemory = 0;
+    readsMemory = 0;
+    hasSideEffects = 0;
+    usesStackFrame = 0;
   }
 };
 
@@ -263,6 +285,27 @@ void AsmStatement_toIR(AsmStatement *stmt, IRState *irs) {
     }
   }
 
+  asmblock->clobbersMemory |= clobbers_mem;
+  asmblock->readsMemory |= code->readsMemory != 0;
+  asmblock->hasSideEffects |= code->hasSideEffects != 0;
+  asmblock->usesStackFrame |= code->usesStackFrame != 0;
+
+  // Registers read before being written in the block are live-ins, e.g., set
+  // by a previous asm block.
+  if (asmblock->definedRegs.size() < code->regs.size()) {
+    asmblock->definedRegs.resize(code->regs.size(), false);
+  }
+  for (size_t i = 0; i < code->regsRead.size(); i++) {
+    if (code->regsRead[i] && !asmblock->definedRegs[i]) {
+      asmblock->readsLiveInRegs = true;
+    }
+  }
+  for (size_t i = 0; i < code->regs.size(); i++) {
+    if (code->regs[i]) {
+      asmblock->definedRegs[i] = true;
+    }
+  }
+
   // Telling GCC that callee-saved registers are clobbered makes it preserve
   // those registers.   This changes the stack from what a naked function
   // expects.
@@ -464,11 +507,6 @@ void CompoundAsmStatement_toIR(CompoundAsmStatement *stmt, IRState *p) {
                          stmt->loc.toChars());
   LOG_SCOPE;
 
-  // disable inlining by default
-  if (!p->func()->decl->allowInlining) {
-    p->func()->setNeverInline();
-  }
-
   // create asm block structure
   assert(!p->asmBlock);
   auto asmblock = new IRAsmBlock(stmt);
@@ -483,6 +521,14 @@ void CompoundAsmStatement_toIR(CompoundAsmStatement *stmt, IRState *p) {
     }
   }
 
+  // disable inlining by default (with -precise-asm, only if the block refers
+  // to the stack frame or labels)
+  if (!p->func()->decl->allowInlining &&
+      (!preciseAsm || asmblock->usesStackFrame ||
+       !asmblock->internalLabels.empty())) {
+    p->func()->setNeverInline();
+  }
+
   // build forwarder for in-asm branches to external labels
   // this additional asm code sets the __llvm_jump_target variable
   // to a unique value that will identify the jump target in
@@ -690,11 +736,29 @@ void CompoundAsmStatement_toIR(CompoundAsmStatement *stmt, IRState *p) {
     Logger::undent();
   }
 
-  llvm::InlineAsm *ia = llvm::InlineAsm::get(fty, code, out_c, true);
+  // With -precise-asm, blocks consisting of instructions without side effects
+  // are only volatile if they don't have any visible results (e.g., because
+  // they pass values in registers to a later block), or if they depend on
+  // registers set before them.
+  const bool writesMemory = asmblock->clobbersMemory || !outargs.empty();
+  const bool sideEffects =
+      !preciseAsm || asmblock->hasSideEffects || asmblock->readsLiveInRegs ||
+      !asmblock->internalLabels.empty() ||
+      (retty->isVoidTy() && !writesMemory);
+
+  llvm::InlineAsm *ia = llvm::InlineAsm::get(fty, code, out_c, sideEffects);
 
   llvm::CallInst *call = p->ir->CreateCall(
       ia, args, retty == LLType::getVoidTy(gIR->context()) ? "" : "asm");
 
+  if (!sideEffects && !writesMemory) {
+    if (asmblock->readsMemory) {
+      call->setOnlyReadsMemory();
+    } else {
+      call->setDoesNotAccessMemory();
+    }
+  }
+
   IF_LOG Logger::cout() << "Complete asm statement: " << *call << '\n';
 
   // capture abi return value
@@ -28,6 +28,15 @@
 #include "ir/iraggr.h"
 #include "ir/irfunction.h"
 #include "ir/irtypeclass.h"
+#include "llvm/Support/CommandLine.h"
+
+#if LDC_LLVM_VER >= 308
+static llvm::cl::opt<bool> strictVtablePointers(
+    "fstrict-vtable-pointers",
+    llvm::cl::desc("Assume that the vtable pointer and immutable fields of a "
+                   "class instance don't change once it has been constructed"),
+    llvm::cl::init(false));
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -77,6 +86,8 @@ void DtoResolveClass(ClassDeclaration *cd) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static LLValue *DtoInvariantGroupBarrier(LLValue *inst);
+
 DValue *DtoNewClass(Loc &loc, TypeClass *tc, NewExp *newexp) {
   // resolve type
   DtoResolveClass(tc->sym);
@@ -97,7 +108,7 @@ DValue *DtoNewClass(Loc &loc, TypeClass *tc, NewExp *newexp) {
   // default allocator
   else {
     llvm::Function *fn =
-        getRuntimeFunction(loc, gIR->module, "_d_newclass");
+        getRuntimeFunction(loc, gIR->module, RTFunc::_d_newclass);
     LLConstant *ci = DtoBitCast(getIrAggr(tc->sym)->getClassInfoSymbol(),
                                 DtoType(Type::typeinfoclass->type));
     mem =
@@ -134,17 +145,49 @@ DValue *DtoNewClass(Loc &loc, TypeClass *tc, NewExp *newexp) {
     assert(newexp->arguments != NULL);
     DtoResolveFunction(newexp->member);
     DFuncValue dfn(newexp->member, getIrFunc(newexp->member)->func, mem);
-    return DtoCallFunction(newexp->loc, tc, &dfn, newexp->arguments);
+    DValue *result = DtoCallFunction(newexp->loc, tc, &dfn, newexp->arguments);
+    return new DImValue(tc, DtoInvariantGroupBarrier(DtoRVal(result)));
   }
 
   assert(newexp->argprefix == NULL);
 
   // return default constructed class
-  return new DImValue(tc, mem);
+  return new DImValue(tc, DtoInvariantGroupBarrier(mem));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void DtoSetInvariantGroup(LLValue *access) {
+#if LDC_LLVM_VER >= 308
+  if (strictVtablePointers) {
+    llvm::cast<llvm::Instruction>(access)->setMetadata(
+        llvm::LLVMContext::MD_invariant_group,
+        llvm::MDNode::get(gIR->context(), llvm::None));
+  }
+#endif
+}
+
+/// Returns a pointer to the same class instance that isn't related to
+/// invariant.group accesses via the given one (which may have seen the
+/// instance during construction).
+static LLValue *DtoInvariantGroupBarrier(LLValue *inst) {
+#if LDC_LLVM_VER >= 308
+  if (strictVtablePointers) {
+    LLValue *barrier =
+        gIR->ir->CreateCall(GET_INTRINSIC_DECL(invariant_group_barrier),
+                            DtoBitCast(inst, getVoidPtrType()));
+    return DtoBitCast(barrier, inst->getType());
+  }
+#endif
+  return inst;
+}
+
+LLValue *DtoLoadVtbl(LLValue *inst) {
+  LLValue *vtbl = DtoLoad(DtoGEPi(inst, 0, 0), "vtbl");
+  DtoSetInvariantGroup(vtbl);
+  return vtbl;
+}
+
 void DtoInitClass(TypeClass *tc, LLValue *dst) {
   DtoResolveClass(tc->sym);
 
@@ -152,7 +195,7 @@ void DtoInitClass(TypeClass *tc, LLValue *dst) {
   LLValue *tmp = DtoGEPi(dst, 0, 0, "vtbl");
   LLValue *val = DtoBitCast(getIrAggr(tc->sym)->getVtblSymbol(),
                             tmp->getType()->getContainedType(0));
-  DtoStore(val, tmp);
+  DtoSetInvariantGroup(gIR->ir->CreateStore(val, tmp));
 
   // For D classes, set the monitor field to null.
   const bool isCPPclass = tc->sym->isCPPclass() ? true : false;
@@ -185,7 +228,7 @@ void DtoInitClass(TypeClass *tc, LLValue *dst) {
 void DtoFinalizeClass(Loc &loc, LLValue *inst) {
   // get runtime function
   llvm::Function *fn =
-      getRuntimeFunction(loc, gIR->module, "_d_callfinalizer");
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_callfinalizer);
 
   gIR->CreateCallOrInvoke(
       fn, DtoBitCast(inst, fn->getFunctionType()->getParamType(0)), "");
@@ -309,7 +352,7 @@ DValue *DtoDynamicCastObject(Loc &loc, DValue *val, Type *_to) {
   DtoResolveClass(Type::typeinfoclass);
 
   llvm::Function *func =
-      getRuntimeFunction(loc, gIR->module, "_d_dynamic_cast");
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_dynamic_cast);
   LLFunctionType *funcTy = func->getFunctionType();
 
   // Object o
@@ -347,7 +390,7 @@ DValue *DtoDynamicCastInterface(Loc &loc, DValue *val, Type *_to) {
   DtoResolveClass(Type::typeinfoclass);
 
   llvm::Function *func =
-      getRuntimeFunction(loc, gIR->module, "_d_interface_cast");
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_interface_cast);
   LLFunctionType *funcTy = func->getFunctionType();
 
   // void* p
@@ -388,17 +431,15 @@ LLValue *DtoVirtualFunctionPointer(DValue *inst, FuncDeclaration *fdecl,
   LLValue *vthis = DtoRVal(inst);
   IF_LOG Logger::cout() << "vthis: " << *vthis << '\n';
 
-  LLValue *funcval = vthis;
-  // get the vtbl for objects
-  funcval = DtoGEPi(funcval, 0, 0);
   // load vtbl ptr
-  funcval = DtoLoad(funcval);
+  LLValue *funcval = DtoLoadVtbl(vthis);
   // index vtbl
   std::string vtblname = name;
   vtblname.append("@vtbl");
   funcval = DtoGEPi(funcval, 0, fdecl->vtblIndex, vtblname.c_str());
-  // load funcptr
+  // load funcptr (vtables are constant)
   funcval = DtoAlignedLoad(funcval);
+  DtoSetInvariantLoad(funcval);
 
   IF_LOG Logger::cout() << "funcval: " << *funcval << '\n';
 
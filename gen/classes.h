@@ -32,6 +32,13 @@ llvm::Constant *DtoDefineClassInfo(ClassDeclaration *cd);
 
 DValue *DtoNewClass(Loc &loc, TypeClass *type, NewExp *newexp);
 void DtoInitClass(TypeClass *tc, llvm::Value *dst);
+
+/// Loads the vtable pointer of the given class instance.
+llvm::Value *DtoLoadVtbl(llvm::Value *inst);
+
+/// With -fstrict-vtable-pointers, marks the given load or store as accessing
+/// memory of a class instance that doesn't change once it is constructed.
+void DtoSetInvariantGroup(llvm::Value *access);
 void DtoFinalizeClass(Loc &loc, llvm::Value *inst);
 
 DValue *DtoCastClass(Loc &loc, DValue *val, Type *to);
@@ -15,6 +15,7 @@
 #include "nspace.h"
 #include "rmem.h"
 #include "template.h"
+#include "driver/cl_options.h"
 #include "gen/classes.h"
 #include "gen/functions.h"
 #include "gen/irstate.h"
@@ -166,8 +167,10 @@ public:
         m->accept(this);
       }
 
-      // Emit TypeInfo.
-      DtoTypeInfoOf(decl->type);
+      // Emit TypeInfo, unless only to be emitted where referenced.
+      if (!opts::lazyTypeInfo) {
+        DtoTypeInfoOf(decl->type);
+      }
 
       // Define __InterfaceZ.
       IrAggr *ir = getIrAggr(decl);
@@ -211,8 +214,10 @@ public:
     initZ->setInitializer(ir->getDefaultInit());
     setLinkage(decl, initZ);
 
-    // emit typeinfo
-    DtoTypeInfoOf(decl->type);
+    // emit typeinfo, unless only to be emitted where referenced
+    if (!opts::lazyTypeInfo) {
+      DtoTypeInfoOf(decl->type);
+    }
 
     // Emit __xopEquals/__xopCmp/__xtoHash.
     if (decl->xeq && decl->xeq != decl->xerreq) {
@@ -590,6 +590,14 @@ void ldc::DIBuilder::EmitCompileUnit(Module *m) {
       isOptimizationEnabled(), // isOptimized
       llvm::StringRef(),       // Flags TODO
       1                        // Runtime Version TODO
+#if LDC_LLVM_VER >= 309
+      ,
+      llvm::StringRef(), // SplitName
+      // Only track the source locations for optimization remarks and sample
+      // profiles if no debug info has been requested.
+      opts::debugLocationsOnly ? llvm::DICompileUnit::NoDebug
+                               : llvm::DICompileUnit::FullDebug
+#endif
       );
 }
 
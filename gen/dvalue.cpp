@@ -9,10 +9,12 @@
 
 #include "gen/dvalue.h"
 #include "declaration.h"
+#include "gen/classes.h"
 #include "gen/irstate.h"
 #include "gen/llvm.h"
 #include "gen/llvmhelpers.h"
 #include "gen/logger.h"
+#include "gen/tbaa.h"
 #include "gen/tollvm.h"
 
 namespace {
@@ -111,6 +113,10 @@ DRValue *DLValue::getRVal() {
   }
 
   LLValue *rval = DtoLoad(val);
+  addTBAAMetadata(rval, this);
+  if (isInvariantGroup) {
+    DtoSetInvariantGroup(rval);
+  }
   if (type->toBasetype()->ty == Tbool) {
     assert(rval->getType() == llvm::Type::getInt8Ty(gIR->context()));
     rval = gIR->ir->CreateTrunc(rval, llvm::Type::getInt1Ty(gIR->context()));
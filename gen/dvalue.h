@@ -155,6 +155,14 @@ public:
 
   DLValue *isLVal() override { return this; }
 
+  /// Whether the memory may also be accessed as a different type, as for
+  /// union members. Such accesses don't get TBAA metadata.
+  bool mayAlias = false;
+
+  /// Whether the memory doesn't change once the class instance containing it
+  /// has been constructed (immutable class fields outside constructors).
+  bool isInvariantGroup = false;
+
 protected:
   DLValue(llvm::Value *v, Type *t) : DValue(t, v) {}
 
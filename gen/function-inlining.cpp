@@ -194,3 +194,46 @@ bool defineAsExternallyAvailable(FuncDeclaration &fdecl) {
   IF_LOG Logger::println("defineAsExternallyAvailable? Yes.");
   return true;
 }
+
+bool defineCopyAsExternallyAvailable(FuncDeclaration &fdecl) {
+  IF_LOG Logger::println("Enter defineCopyAsExternallyAvailable");
+  LOG_SCOPE
+
+#if LDC_LLVM_VER < 307
+  return false;
+#endif
+
+  if (fdecl.neverInline || fdecl.inlining == PINLINEnever) {
+    IF_LOG Logger::println("pragma(inline, false) specified");
+    return false;
+  }
+  if (fdecl.inlining != PINLINEalways && !willCrossModuleInline()) {
+    IF_LOG Logger::println("Commandline flags indicate no inlining");
+    return false;
+  }
+
+  if (!fdecl.fbody || fdecl.naked || fdecl.isUnitTestDeclaration()) {
+    return false;
+  }
+  // Nested functions need the context of their parent.
+  if (fdecl.isNested()) {
+    IF_LOG Logger::println("Nested functions are not copied.");
+    return false;
+  }
+  // See defineAsExternallyAvailable().
+  if (fdecl.getModule()->ident == Id::object) {
+    return false;
+  }
+
+  if (fdecl.inlining != PINLINEalways && !isInlineCandidate(fdecl)) {
+    return false;
+  }
+
+  IF_LOG Logger::println("defineCopyAsExternallyAvailable? Yes.");
+  return true;
+}
+
+bool hasCrossModuleInlinableBody(FuncDeclaration *fdecl) {
+  return fdecl->semanticRun >= PASSsemantic3done && !fdecl->semantic3Errors &&
+         defineCopyAsExternallyAvailable(*fdecl);
+}
@@ -26,4 +26,16 @@ bool alreadyOrWillBeDefined(FuncDeclaration &fdecl);
 /// If true, `semantic3` will have been run on the declaration.
 bool defineAsExternallyAvailable(FuncDeclaration &fdecl);
 
+/// Returns whether an available_externally copy of `fdecl`, whose definition
+/// is emitted into another object file of the same compilation, should be
+/// emitted to make it available for inlining.
+///
+/// Semantic analysis of `fdecl` must be complete.
+bool defineCopyAsExternallyAvailable(FuncDeclaration &fdecl);
+
+/// Returns whether the body of `fdecl` is made available to importing modules
+/// for inlining, i.e., whether it is part of the module interface (see
+/// driver/interfacehash.d).
+bool hasCrossModuleInlinableBody(FuncDeclaration *fdecl);
+
 #endif
@@ -18,6 +18,7 @@
 #include "mtype.h"
 #include "statement.h"
 #include "template.h"
+#include "driver/cl_options.h"
 #include "gen/abi.h"
 #include "gen/arrays.h"
 #include "gen/classes.h"
@@ -39,10 +40,76 @@
 #include "gen/uda.h"
 #include "ir/irfunction.h"
 #include "ir/irmodule.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/CFG.h"
 #include <iostream>
 
+namespace {
+
+/// Adds the attributes implied by the D parameter type and storage class to
+/// an explicit parameter that is passed as a plain LLVM pointer.
+void addPointerParamAttrs(Parameter *arg, AttrBuilder &attrs) {
+  Type *t = arg->type->toBasetype();
+  if (t->ty != Tpointer && t->ty != Tclass) {
+    return;
+  }
+
+  // Escaping a scope reference is undefined behavior.
+  if (arg->storageClass & STCscope) {
+    attrs.add(LLAttribute::NoCapture);
+  }
+
+  // Immutable data can't be written (through any pointer), which is all that
+  // noalias requires. Class references are excluded, as the monitor field may
+  // still be modified.
+  if (t->ty == Tpointer && t->nextOf()->isImmutable()) {
+    attrs.add(LLAttribute::NoAlias).add(LLAttribute::ReadOnly);
+  }
+}
+
+/// Adds the function attributes implied by the D function type.
+void addFunctionTypeAttrs(TypeFunction *f, IrFuncTy &irFty,
+                          bool hasContext) {
+  // nothrow functions may still throw Errors, but unwinding cleanups and
+  // catching Errors is not guaranteed to work in that case (as with DMD).
+  if (!f->isnothrow) {
+    return;
+  }
+  irFty.fnAttrs.add(LLAttribute::NoUnwind);
+
+  // Strongly pure functions only depend on their (value or immutable)
+  // parameters. Calls can only be merged or hoisted if the result doesn't
+  // contain mutable indirections though (which could be freshly allocated),
+  // and if the function doesn't write to memory via sret or a context.
+  // The purity level is computed lazily (PUREfwdref until then).
+  f->purityLevel();
+  if (f->purity != PUREstrong || f->varargs || hasContext || irFty.arg_sret) {
+    return;
+  }
+  // Void functions are only called for their side effects, e.g., assertions
+  // in a validation function, which must not be optimized away.
+  Type *rt = f->next->toBasetype();
+  if (rt->ty == Tvoid || f->isref ||
+      (rt->hasPointers() && !rt->isImmutable())) {
+    return;
+  }
+
+  // Parameters passed in memory may be written to by the callee. Otherwise,
+  // the function is readnone if no parameter contains (immutable)
+  // indirections.
+  bool readsMemory = false;
+  for (auto arg : irFty.args) {
+    if (arg->byref || arg->isByVal()) {
+      return;
+    }
+    readsMemory = readsMemory || arg->type->hasPointers();
+  }
+  irFty.fnAttrs.add(readsMemory ? LLAttribute::ReadOnly
+                                : LLAttribute::ReadNone);
+}
+}
+
 llvm::FunctionType *DtoFunctionType(Type *type, IrFuncTy &irFty, Type *thistype,
                                     Type *nesttype, bool isMain, bool isCtor,
                                     bool isIntrinsic, bool hasSel) {
@@ -161,6 +228,9 @@ llvm::FunctionType *DtoFunctionType(Type *type, IrFuncTy &irFty, Type *thistype,
     } else if (passPointer) {
       // ref/out
       attrs.addDereferenceable(loweredDType->size());
+      if (loweredDType->isImmutable()) {
+        attrs.add(LLAttribute::NoAlias).add(LLAttribute::ReadOnly);
+      }
     } else {
       if (abi->passByVal(loweredDType)) {
         // LLVM ByVal parameters are pointers to a copy in the function
@@ -171,6 +241,7 @@ llvm::FunctionType *DtoFunctionType(Type *type, IrFuncTy &irFty, Type *thistype,
       } else {
         // Add sext/zext as needed.
         attrs.add(DtoShouldExtend(loweredDType));
+        addPointerParamAttrs(arg, attrs);
       }
     }
 
@@ -182,6 +253,10 @@ llvm::FunctionType *DtoFunctionType(Type *type, IrFuncTy &irFty, Type *thistype,
   // let the ABI rewrite the types as necessary
   abi->rewriteFunctionType(f, newIrFty);
 
+  if (!isMain && !isIntrinsic) {
+    addFunctionTypeAttrs(f, newIrFty, thistype || nesttype);
+  }
+
   // Now we can modify irFty safely.
   irFty = llvm_move(newIrFty);
 
@@ -734,6 +809,31 @@ void defineParameters(IrFuncTy &irFty, VarDeclarations &parameters) {
   }
 }
 
+/// The modules whose object files contain the definitions of the template
+/// instance functions emitted so far.
+llvm::DenseMap<FuncDeclaration *, Module *> instanceOwners;
+
+/// Returns whether the definition of `fd` is to be emitted into the object
+/// file of the current module. When emitting multiple object files, template
+/// instance functions (weak_odr) are only defined in the first module
+/// emitting them; all other modules merely reference that definition.
+bool ownsDefinition(FuncDeclaration *fd) {
+  if (global.params.singleObj || !opts::dedupTemplateInstances ||
+      opts::linkonceTemplates) {
+    return true;
+  }
+
+  if (lowerFuncLinkage(fd).first != llvm::GlobalValue::WeakODRLinkage) {
+    return true;
+  }
+
+  Module *&owner = instanceOwners[fd];
+  if (!owner) {
+    owner = gIR->dmodule;
+  }
+  return owner == gIR->dmodule;
+}
+
 } // anonymous namespace
 
 void DtoDefineFunction(FuncDeclaration *fd, bool linkageAvailableExternally) {
@@ -856,6 +956,15 @@ void DtoDefineFunction(FuncDeclaration *fd, bool linkageAvailableExternally) {
     }
   }
 
+  if (!linkageAvailableExternally && !ownsDefinition(fd)) {
+    if (!defineCopyAsExternallyAvailable(*fd)) {
+      IF_LOG Logger::println("Already defined for module '%s', skipping.",
+                             instanceOwners[fd]->toChars());
+      return;
+    }
+    linkageAvailableExternally = true;
+  }
+
   // if this function is naked, we take over right away! no standard processing!
   if (fd->naked) {
     DtoDefineNakedFunction(fd);
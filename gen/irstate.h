@@ -56,6 +56,13 @@ class AnonDeclaration;
 struct IrFunction;
 struct IrModule;
 
+// a function to be multiversioned via @target_clones
+struct TargetClones {
+  FuncDeclaration *decl;
+  llvm::Function *func;
+  std::vector<std::string> specs;
+};
+
 // represents a scope
 struct IRScope {
   llvm::BasicBlock *begin;
@@ -99,9 +106,19 @@ struct IRAsmBlock {
   bool retemu; // emulate abi ret with a temporary
   LLValue *(*retfixup)(IRBuilderHelper b, LLValue *orig); // Modifies retval
 
+  // effects of the contained instructions (see AsmCode)
+  bool clobbersMemory;
+  bool readsMemory;
+  bool hasSideEffects;
+  bool usesStackFrame;
+  // registers written so far, and whether any register is read before
+  bool readsLiveInRegs;
+  std::vector<bool> definedRegs;
+
   explicit IRAsmBlock(CompoundAsmStatement *b)
       : outputcount(0), asmBlock(b), retty(nullptr), retn(0), retemu(false),
-        retfixup(nullptr) {}
+        retfixup(nullptr), clobbersMemory(false), readsMemory(false),
+        hasSideEffects(false), usesStackFrame(false), readsLiveInRegs(false) {}
 };
 
 // represents the module
@@ -159,6 +176,10 @@ struct IRState {
   // debug info helper
   ldc::DIBuilder DBuilder;
 
+  // TBAA root and access tags, see gen/tbaa.cpp
+  llvm::MDNode *TBAARoot = nullptr;
+  llvm::StringMap<llvm::MDNode *> TBAAAccessTags;
+
   // PGO data file reader
   std::unique_ptr<llvm::IndexedInstrProfReader> PGOReader;
   llvm::IndexedInstrProfReader *getPGOReader() const { return PGOReader.get(); }
@@ -171,6 +192,14 @@ struct IRState {
   // eliminated.
   std::vector<LLConstant *> usedArray;
 
+  // Hashed symbol names (see -hash-threshold) mapped to the full mangled names
+  // they replace, written to the -hash-map file of the object file.
+  llvm::StringMap<std::string> hashedSymbolNames;
+
+  // Functions with @target_clones, multiversioned once the module is complete
+  // (see gen/targetclones.cpp).
+  std::vector<TargetClones> targetClones;
+
   /// Whether to emit array bounds checking in the current function.
   bool emitArrayBoundsChecks();
 
@@ -0,0 +1,289 @@
+//===-- layoutreport.cpp --------------------------------------------------===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gen/layoutreport.h"
+
+#include "aggregate.h"
+#include "declaration.h"
+#include "globals.h"
+#include "module.h"
+#include "mtype.h"
+#include "target.h"
+#include "driver/cl_options.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const unsigned cacheLineSize = 64;
+
+struct AggregateLayout {
+  AggregateDeclaration *ad;
+  unsigned paddingSize;
+};
+
+std::vector<AggregateLayout> aggregates;
+llvm::DenseMap<VarDeclaration *, uint64_t> fieldAccessCounts;
+
+const char *kindOf(AggregateDeclaration *ad) {
+  if (ad->isUnionDeclaration()) {
+    return "union";
+  }
+  if (ad->isClassDeclaration()) {
+    return "class";
+  }
+  return "struct";
+}
+
+unsigned fieldAlignment(VarDeclaration *vd) {
+  return std::max(Target::fieldalign(vd->type), 1u);
+}
+
+bool fieldsOverlap(AggregateDeclaration *ad) {
+  for (size_t i = 1; i < ad->fields.dim; ++i) {
+    VarDeclaration *prev = ad->fields[i - 1];
+    if (ad->fields[i]->offset < prev->offset + prev->type->size()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Returns the fields of a struct ordered to minimize its size (by decreasing
+/// alignment, then size), and that size. Returns an empty list if reordering
+/// doesn't make the struct smaller.
+std::vector<VarDeclaration *> suggestFieldOrder(AggregateDeclaration *ad,
+                                                unsigned &newSize) {
+  std::vector<VarDeclaration *> order;
+  if (!ad->isStructDeclaration() || ad->isUnionDeclaration() ||
+      ad->fields.dim < 2 || fieldsOverlap(ad)) {
+    return order;
+  }
+
+  for (auto vd : ad->fields) {
+    order.push_back(vd);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [](VarDeclaration *a, VarDeclaration *b) {
+                     const unsigned alignA = fieldAlignment(a);
+                     const unsigned alignB = fieldAlignment(b);
+                     if (alignA != alignB) {
+                       return alignA > alignB;
+                     }
+                     return a->type->size() > b->type->size();
+                   });
+
+  // Mirror AggregateDeclaration::placeField().
+  unsigned offset = 0;
+  unsigned aggAlignment = 1;
+  for (auto vd : order) {
+    const unsigned alignment = fieldAlignment(vd);
+    AggregateDeclaration::alignmember(vd->alignment, alignment, &offset);
+    offset += vd->type->size();
+    aggAlignment = std::max(aggAlignment, vd->alignment == STRUCTALIGN_DEFAULT
+                                              ? alignment
+                                              : vd->alignment);
+  }
+  AggregateDeclaration::alignmember(STRUCTALIGN_DEFAULT, aggAlignment,
+                                    &offset);
+  newSize = std::max(offset, 1u);
+
+  if (newSize >= ad->structsize) {
+    order.clear();
+  }
+  return order;
+}
+
+/// Returns whether field `vd` straddles a cache line boundary, assuming the
+/// object starts at one. Fields larger than a cache line are not counted.
+bool straddlesCacheLine(VarDeclaration *vd) {
+  const unsigned size = vd->type->size();
+  if (size == 0 || size > cacheLineSize) {
+    return false;
+  }
+  return vd->offset / cacheLineSize !=
+         (vd->offset + size - 1) / cacheLineSize;
+}
+
+/// Returns the fields beyond the first cache line which are accessed at least
+/// a tenth as often as the most frequently accessed field of `ad`.
+std::vector<VarDeclaration *> findHotFarFields(AggregateDeclaration *ad) {
+  std::vector<VarDeclaration *> result;
+  uint64_t maxCount = 0;
+  for (auto vd : ad->fields) {
+    maxCount = std::max(maxCount, fieldAccessCounts.lookup(vd));
+  }
+  if (maxCount == 0) {
+    return result;
+  }
+  for (auto vd : ad->fields) {
+    const uint64_t count = fieldAccessCounts.lookup(vd);
+    if (vd->offset >= cacheLineSize && count > 0 && count >= maxCount / 10) {
+      result.push_back(vd);
+    }
+  }
+  return result;
+}
+
+void writeJSONString(llvm::raw_ostream &os, llvm::StringRef str) {
+  os << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      os << llvm::format("\\u%04x", c);
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+void printText(llvm::raw_ostream &os, const AggregateLayout &layout) {
+  AggregateDeclaration *ad = layout.ad;
+  os << "layout    " << kindOf(ad) << ' ' << ad->toPrettyChars()
+     << ": size " << ad->structsize << ", alignment " << ad->alignsize
+     << ", padding " << layout.paddingSize << '\n';
+
+  for (auto vd : ad->fields) {
+    os << llvm::format("layout    %6u %6u  ", vd->offset,
+                       static_cast<unsigned>(vd->type->size()))
+       << vd->type->toChars() << ' ' << vd->toChars() << '\n';
+  }
+
+  for (auto vd : ad->fields) {
+    if (straddlesCacheLine(vd)) {
+      os << "layout      cache line split: " << vd->toChars() << " (offset "
+         << vd->offset << ", size " << vd->type->size() << ")\n";
+    }
+  }
+
+  unsigned newSize = 0;
+  const auto order = suggestFieldOrder(ad, newSize);
+  if (!order.empty()) {
+    os << "layout      suggested order (size " << newSize << "):";
+    for (size_t i = 0; i < order.size(); ++i) {
+      os << (i ? ", " : " ") << order[i]->toChars();
+    }
+    os << '\n';
+  }
+
+  for (auto vd : findHotFarFields(ad)) {
+    os << "layout      hot field beyond first cache line: " << vd->toChars()
+       << " (offset " << vd->offset << ", count "
+       << fieldAccessCounts.lookup(vd) << ")\n";
+  }
+}
+
+void printJSON(llvm::raw_ostream &os, const AggregateLayout &layout) {
+  AggregateDeclaration *ad = layout.ad;
+  os << "{\"kind\":\"" << kindOf(ad) << "\",\"name\":";
+  writeJSONString(os, ad->toPrettyChars());
+  os << ",\"size\":" << ad->structsize << ",\"alignment\":" << ad->alignsize
+     << ",\"padding\":" << layout.paddingSize << ",\"fields\":[";
+  for (size_t i = 0; i < ad->fields.dim; ++i) {
+    VarDeclaration *vd = ad->fields[i];
+    os << (i ? "," : "") << "{\"name\":";
+    writeJSONString(os, vd->toChars());
+    os << ",\"type\":";
+    writeJSONString(os, vd->type->toChars());
+    os << ",\"offset\":" << vd->offset << ",\"size\":" << vd->type->size();
+    if (const uint64_t count = fieldAccessCounts.lookup(vd)) {
+      os << ",\"count\":" << count;
+    }
+    os << '}';
+  }
+
+  os << "],\"cacheLineSplits\":[";
+  bool first = true;
+  for (auto vd : ad->fields) {
+    if (straddlesCacheLine(vd)) {
+      os << (first ? "" : ",");
+      writeJSONString(os, vd->toChars());
+      first = false;
+    }
+  }
+  os << ']';
+
+  unsigned newSize = 0;
+  const auto order = suggestFieldOrder(ad, newSize);
+  if (!order.empty()) {
+    os << ",\"suggestedOrder\":[";
+    for (size_t i = 0; i < order.size(); ++i) {
+      os << (i ? "," : "");
+      writeJSONString(os, order[i]->toChars());
+    }
+    os << "],\"suggestedSize\":" << newSize;
+  }
+
+  const auto hotFields = findHotFarFields(ad);
+  if (!hotFields.empty()) {
+    os << ",\"hotFarFields\":[";
+    for (size_t i = 0; i < hotFields.size(); ++i) {
+      os << (i ? "," : "");
+      writeJSONString(os, hotFields[i]->toChars());
+    }
+    os << ']';
+  }
+  os << "}\n";
+}
+}
+
+bool isLayoutReportEnabled() {
+  return opts::layoutReport.getNumOccurrences() > 0;
+}
+
+void addAggregateLayout(AggregateDeclaration *ad, unsigned paddingSize) {
+  if (!isLayoutReportEnabled() || ad->isInterfaceDeclaration()) {
+    return;
+  }
+  // Only report the aggregates of the compiled modules.
+  Module *m = ad->getModule();
+  if (!m || !m->isRoot()) {
+    return;
+  }
+  aggregates.push_back({ad, paddingSize});
+}
+
+void addFieldAccessCount(VarDeclaration *vd, uint64_t count) {
+  fieldAccessCounts[vd] += count;
+}
+
+void printLayoutReport() {
+  if (!isLayoutReportEnabled()) {
+    return;
+  }
+
+  std::stable_sort(aggregates.begin(), aggregates.end(),
+                   [](const AggregateLayout &a, const AggregateLayout &b) {
+                     return strcmp(a.ad->toPrettyChars(),
+                                   b.ad->toPrettyChars()) < 0;
+                   });
+
+  const bool json = opts::layoutReport == "json";
+  std::string buffer;
+  llvm::raw_string_ostream os(buffer);
+  for (const auto &layout : aggregates) {
+    if (json) {
+      printJSON(os, layout);
+    } else {
+      printText(os, layout);
+    }
+  }
+  os.flush();
+  fputs(buffer.c_str(), global.stdmsg);
+  aggregates.clear();
+}
@@ -0,0 +1,38 @@
+//===-- gen/layoutreport.h - Aggregate layout report ------------*- C++ -*-===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Collects the layouts of the aggregates of the compiled modules and reports
+// padding, fields straddling cache lines, size-minimizing field orderings and
+// (with a PGO profile) hot fields far from the object start (-vlayout).
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LDC_GEN_LAYOUTREPORT_H
+#define LDC_GEN_LAYOUTREPORT_H
+
+#include <cstdint>
+
+class AggregateDeclaration;
+class VarDeclaration;
+
+/// Returns whether -vlayout has been specified.
+bool isLayoutReportEnabled();
+
+/// Adds an aggregate whose LLVM type has just been built to the report.
+/// `paddingSize` is the number of padding bytes inserted into the type.
+void addAggregateLayout(AggregateDeclaration *ad, unsigned paddingSize);
+
+/// Records an access to field `vd` executed `count` times according to the
+/// PGO profile.
+void addFieldAccessCount(VarDeclaration *vd, uint64_t count);
+
+/// Prints the report for all aggregates added so far (if enabled).
+void printLayoutReport();
+
+#endif
@@ -17,6 +17,7 @@
 #include "gen/dvalue.h"
 #include "gen/functions.h"
 #include "gen/irstate.h"
+#include "gen/layoutreport.h"
 #include "gen/llvm.h"
 #include "gen/llvmcompat.h"
 #include "gen/logger.h"
@@ -24,6 +25,7 @@
 #include "gen/mangling.h"
 #include "gen/pragma.h"
 #include "gen/runtime.h"
+#include "gen/tbaa.h"
 #include "gen/tollvm.h"
 #include "gen/typinf.h"
 #include "gen/uda.h"
@@ -82,7 +84,8 @@ llvm::LLVMContext &getGlobalContext() { return *GlobalContext; }
 
 LLValue *DtoNew(Loc &loc, Type *newtype) {
   // get runtime function
-  llvm::Function *fn = getRuntimeFunction(loc, gIR->module, "_d_allocmemoryT");
+  llvm::Function *fn =
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_allocmemoryT);
   // get type info
   LLConstant *ti = DtoTypeInfoOf(newtype);
   assert(isaPointer(ti));
@@ -95,21 +98,24 @@ LLValue *DtoNew(Loc &loc, Type *newtype) {
 LLValue *DtoNewStruct(Loc &loc, TypeStruct *newtype) {
   llvm::Function *fn = getRuntimeFunction(
       loc, gIR->module,
-      newtype->isZeroInit(newtype->sym->loc) ? "_d_newitemT" : "_d_newitemiT");
+      newtype->isZeroInit(newtype->sym->loc) ? RTFunc::_d_newitemT
+                                             : RTFunc::_d_newitemiT);
   LLConstant *ti = DtoTypeInfoOf(newtype);
   LLValue *mem = gIR->CreateCallOrInvoke(fn, ti, ".gc_struct").getInstruction();
   return DtoBitCast(mem, DtoPtrToType(newtype), ".gc_struct");
 }
 
 void DtoDeleteMemory(Loc &loc, DValue *ptr) {
-  llvm::Function *fn = getRuntimeFunction(loc, gIR->module, "_d_delmemory");
+  llvm::Function *fn =
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_delmemory);
   LLValue *lval = (ptr->isLVal() ? DtoLVal(ptr) : makeLValue(loc, ptr));
   gIR->CreateCallOrInvoke(
       fn, DtoBitCast(lval, fn->getFunctionType()->getParamType(0)));
 }
 
 void DtoDeleteStruct(Loc &loc, DValue *ptr) {
-  llvm::Function *fn = getRuntimeFunction(loc, gIR->module, "_d_delstruct");
+  llvm::Function *fn =
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_delstruct);
   LLValue *lval = (ptr->isLVal() ? DtoLVal(ptr) : makeLValue(loc, ptr));
   gIR->CreateCallOrInvoke(
       fn, DtoBitCast(lval, fn->getFunctionType()->getParamType(0)),
@@ -118,21 +124,24 @@ void DtoDeleteStruct(Loc &loc, DValue *ptr) {
 }
 
 void DtoDeleteClass(Loc &loc, DValue *inst) {
-  llvm::Function *fn = getRuntimeFunction(loc, gIR->module, "_d_delclass");
+  llvm::Function *fn =
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_delclass);
   LLValue *lval = (inst->isLVal() ? DtoLVal(inst) : makeLValue(loc, inst));
   gIR->CreateCallOrInvoke(
       fn, DtoBitCast(lval, fn->getFunctionType()->getParamType(0)));
 }
 
 void DtoDeleteInterface(Loc &loc, DValue *inst) {
-  llvm::Function *fn = getRuntimeFunction(loc, gIR->module, "_d_delinterface");
+  llvm::Function *fn =
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_delinterface);
   LLValue *lval = (inst->isLVal() ? DtoLVal(inst) : makeLValue(loc, inst));
   gIR->CreateCallOrInvoke(
       fn, DtoBitCast(lval, fn->getFunctionType()->getParamType(0)));
 }
 
 void DtoDeleteArray(Loc &loc, DValue *arr) {
-  llvm::Function *fn = getRuntimeFunction(loc, gIR->module, "_d_delarray_t");
+  llvm::Function *fn =
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_delarray_t);
   llvm::FunctionType *fty = fn->getFunctionType();
 
   // the TypeInfo argument must be null if the type has no dtor
@@ -196,7 +205,8 @@ llvm::AllocaInst *DtoRawAlloca(LLType *lltype, size_t alignment,
 
 LLValue *DtoGcMalloc(Loc &loc, LLType *lltype, const char *name) {
   // get runtime function
-  llvm::Function *fn = getRuntimeFunction(loc, gIR->module, "_d_allocmemory");
+  llvm::Function *fn =
+      getRuntimeFunction(loc, gIR->module, RTFunc::_d_allocmemory);
   // parameters
   LLValue *size = DtoConstSize_t(getTypeAllocSize(lltype));
   // call runtime allocator
@@ -244,7 +254,7 @@ LLValue *DtoAllocaDump(LLValue *val, LLType *asType, int alignment,
 
 void DtoAssert(Module *M, Loc &loc, DValue *msg) {
   // func
-  const char *fname = msg ? "_d_assert_msg" : "_d_assert";
+  RTFunc::Type fname = msg ? RTFunc::_d_assert_msg : RTFunc::_d_assert;
   llvm::Function *fn = getRuntimeFunction(loc, gIR->module, fname);
 
   // Arguments
@@ -342,7 +352,7 @@ void DtoAssign(Loc &loc, DValue *lhs, DValue *rhs, int op,
       Logger::cout() << "r : " << *r << '\n';
     }
     r = DtoBitCast(r, l->getType()->getContainedType(0));
-    DtoStore(r, l);
+    addTBAAMetadata(gIR->ir->CreateStore(r, l), lhs->isLVal());
   } else if (t->iscomplex()) {
     LLValue *dst = DtoLVal(lhs);
     LLValue *src = DtoRVal(DtoCast(loc, rhs, lhs->type));
@@ -372,7 +382,7 @@ void DtoAssign(Loc &loc, DValue *lhs, DValue *rhs, int op,
       assert(r->getType() == lit);
 #endif
     }
-    gIR->ir->CreateStore(r, l);
+    addTBAAMetadata(gIR->ir->CreateStore(r, l), lhs->isLVal());
   }
 }
 
@@ -1781,6 +1791,14 @@ LLValue *DtoIndexAggregate(LLValue *src, AggregateDeclaration *ad,
   // Cast the (possibly void*) pointer to the canonical variable type.
   val = DtoBitCast(val, DtoPtrToType(vd->type));
 
+  // Let the layout report know how often the field is accessed.
+  if (isLayoutReportEnabled() && !gIR->functions.empty()) {
+    const auto &pgo = gIR->func()->pgo;
+    if (pgo.haveRegionCounts()) {
+      addFieldAccessCount(vd, pgo.getCurrentRegionCount());
+    }
+  }
+
   IF_LOG Logger::cout() << "Value: " << *val << '\n';
   return val;
 }
@@ -15,23 +15,159 @@
 
 #include "ddmd/declaration.h"
 #include "ddmd/dsymbol.h"
+#include "ddmd/errors.h"
+#include "ddmd/expression.h"
 #include "ddmd/identifier.h"
 #include "ddmd/module.h"
+#include "ddmd/mtype.h"
+#include "ddmd/template.h"
 #include "gen/abi.h"
 #include "gen/irstate.h"
+#include "gen/logger.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MD5.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cstring>
+
+#if LDC_LLVM_VER >= 306
+using LLErrorInfo = std::error_code;
+#define ERRORINFO_STRING(errinfo) errinfo.message().c_str()
+#else
+using LLErrorInfo = std::string;
+#define ERRORINFO_STRING(errinfo) errinfo.c_str()
+#endif
+
+static llvm::cl::opt<bool> hashMap(
+    "hash-map",
+    llvm::cl::desc("Write the full names of the symbols hashed due to "
+                   "-hash-threshold to a <object file>.symmap file"),
+    llvm::cl::ZeroOrMore);
 
 namespace {
 
-// TODO: Disable hashing of symbols that are defined in libdruntime and
-// libphobos. This would enable hashing thresholds below the largest symbol in
-// libdruntime/phobos.
+/// Returns whether `m` is a druntime or Phobos module.
+bool isDruntimeOrPhobosModule(Module *m) {
+  if (!m) {
+    return false;
+  }
+  if (!m->md || !m->md->packages || !m->md->packages->dim) {
+    // object.d is the only top-level druntime module
+    return m->md && strcmp(m->ident->toChars(), "object") == 0;
+  }
+  llvm::StringRef root = (*m->md->packages)[0]->toChars();
+  return root == "core" || root == "std" || root == "etc" || root == "ldc" ||
+         root == "rt" || root == "gc";
+}
+
+bool isDruntimeOrPhobosSymbol(Dsymbol *symb);
+
+bool isDruntimeOrPhobosType(Type *t) {
+  if (!t) {
+    return true;
+  }
+  if (Dsymbol *s = t->toDsymbol(nullptr)) {
+    return isDruntimeOrPhobosSymbol(s);
+  }
+  switch (t->ty) {
+  case Taarray:
+    return isDruntimeOrPhobosType(static_cast<TypeAArray *>(t)->index) &&
+           isDruntimeOrPhobosType(t->nextOf());
+  case Tfunction: {
+    auto tf = static_cast<TypeFunction *>(t);
+    if (tf->parameters) {
+      for (auto param : *tf->parameters) {
+        if (!isDruntimeOrPhobosType(param->type)) {
+          return false;
+        }
+      }
+    }
+    return isDruntimeOrPhobosType(tf->next);
+  }
+  case Ttuple: {
+    auto tt = static_cast<TypeTuple *>(t);
+    if (tt->arguments) {
+      for (auto arg : *tt->arguments) {
+        if (!isDruntimeOrPhobosType(arg->type)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+  default:
+    // Basic types, or pointers, arrays, delegates etc. of the next type.
+    return isDruntimeOrPhobosType(t->nextOf());
+  }
+}
+
+/// Returns whether the template argument `o` only refers to druntime or
+/// Phobos symbols and types.
+bool isDruntimeOrPhobosTemplateArg(RootObject *o) {
+  if (Type *t = isType(o)) {
+    return isDruntimeOrPhobosType(t);
+  }
+  if (Expression *e = isExpression(o)) {
+    if (e->op == TOKfunction) {
+      return isDruntimeOrPhobosSymbol(static_cast<FuncExp *>(e)->fd);
+    }
+    if (e->op == TOKvar || e->op == TOKsymoff) {
+      return isDruntimeOrPhobosSymbol(static_cast<SymbolExp *>(e)->var);
+    }
+    return isDruntimeOrPhobosType(e->type);
+  }
+  if (Dsymbol *s = isDsymbol(o)) {
+    return isDruntimeOrPhobosSymbol(s);
+  }
+  if (Tuple *tup = isTuple(o)) {
+    for (auto elem : tup->objects) {
+      if (!isDruntimeOrPhobosTemplateArg(elem)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// Returns whether the symbol belongs to druntime or Phobos. These are never
+/// hashed, as the libraries are built without hashing; this makes hashing
+/// thresholds below their longest symbols possible. Template instances belong
+/// to the module declaring the template, but only count as library symbols if
+/// all template arguments do too. Instances with user-defined arguments can't
+/// be emitted by the libraries, so hashing their (typically very long) names
+/// is safe.
+bool isDruntimeOrPhobosSymbol(Dsymbol *symb) {
+  if (!symb || !isDruntimeOrPhobosModule(symb->getModule())) {
+    return false;
+  }
+  for (Dsymbol *p = symb; p; p = p->parent) {
+    TemplateInstance *ti = p->isTemplateInstance();
+    if (!ti || !ti->tiargs) {
+      continue;
+    }
+    for (auto arg : *ti->tiargs) {
+      if (!isDruntimeOrPhobosTemplateArg(arg)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool shouldHashName(llvm::StringRef name, Dsymbol *symb) {
+  return (global.params.hashThreshold != 0) &&
+         (name.size() > global.params.hashThreshold) &&
+         !isDruntimeOrPhobosSymbol(symb);
+}
 
-bool shouldHashAggrName(llvm::StringRef name) {
+bool shouldHashAggrName(llvm::StringRef name, Dsymbol *symb) {
   /// Add extra chars to the length of aggregate names to account for
   /// the additional D mangling suffix and prefix
   return (global.params.hashThreshold != 0) &&
-         ((name.size() + 11) > global.params.hashThreshold);
+         ((name.size() + 11) > global.params.hashThreshold) &&
+         !isDruntimeOrPhobosSymbol(symb);
 }
 
 llvm::SmallString<32> hashName(llvm::StringRef name) {
@@ -55,16 +191,17 @@ std::string hashSymbolName(llvm::StringRef name, Dsymbol *symb) {
 
   // module
   {
-    auto moddecl = symb->getModule()->md;
-    assert(moddecl);
-    if (auto packages = moddecl->packages) {
-      for (size_t i = 0; i < packages->dim; ++i) {
-        llvm::StringRef str = (*packages)[i]->toChars();
-        ret += std::to_string(str.size());
-        ret += str;
+    Module *m = symb->getModule();
+    if (auto moddecl = m->md) {
+      if (auto packages = moddecl->packages) {
+        for (size_t i = 0; i < packages->dim; ++i) {
+          llvm::StringRef str = (*packages)[i]->toChars();
+          ret += std::to_string(str.size());
+          ret += str;
+        }
       }
     }
-    llvm::StringRef str = moddecl->id->toChars();
+    llvm::StringRef str = m->ident->toChars();
     ret += std::to_string(str.size());
     ret += str;
   }
@@ -94,6 +231,37 @@ std::string hashSymbolName(llvm::StringRef name, Dsymbol *symb) {
 
   return ret;
 }
+
+/// Remembers the full name replaced by a hashed one for the symbol map of the
+/// current object file. Two different symbols ending up with the same hashed
+/// name would silently be merged by the linker, so that is an error.
+void recordHashedName(const std::string &hashedName,
+                      const std::string &fullName, Dsymbol *symb) {
+  if (!gIR) {
+    return;
+  }
+  auto it = gIR->hashedSymbolNames.insert(std::make_pair(hashedName, fullName));
+  if (!it.second && it.first->second != fullName) {
+    error(symb->loc, "hashed symbol name `%s` of `%s` collides with the one of "
+                     "`%s`",
+          hashedName.c_str(), fullName.c_str(), it.first->second.c_str());
+  }
+}
+
+/// Returns the name of an aggregate-level symbol (_D<aggregate><suffix>),
+/// hashing the aggregate part if it is too long.
+std::string getAggrSymbolName(AggregateDeclaration *aggrdecl,
+                              const char *suffix) {
+  std::string mangledName = mangle(aggrdecl);
+  std::string fullName = "_D" + mangledName + suffix;
+  if (!shouldHashAggrName(mangledName, aggrdecl)) {
+    return fullName;
+  }
+
+  std::string ret = "_D" + hashSymbolName(mangledName, aggrdecl) + suffix;
+  recordHashedName(ret, fullName, aggrdecl);
+  return ret;
+}
 }
 
 std::string getMangledName(FuncDeclaration *fdecl, LINK link) {
@@ -101,11 +269,10 @@ std::string getMangledName(FuncDeclaration *fdecl, LINK link) {
 
   // Hash the name if necessary
   if (((link == LINKd) || (link == LINKdefault)) &&
-      (global.params.hashThreshold != 0) &&
-      (mangledName.length() > global.params.hashThreshold)) {
-
-    auto hashedName = hashSymbolName(mangledName, fdecl);
-    mangledName = "_D" + hashedName + "Z";
+      shouldHashName(mangledName, fdecl)) {
+    std::string hashedName = "_D" + hashSymbolName(mangledName, fdecl) + "Z";
+    recordHashedName(hashedName, mangledName, fdecl);
+    mangledName = std::move(hashedName);
   }
 
   // TODO: Cache the result?
@@ -122,50 +289,48 @@ std::string getMangledName(VarDeclaration *vd) {
 }
 
 std::string getMangledInitSymbolName(AggregateDeclaration *aggrdecl) {
-  std::string ret = "_D";
-
-  std::string mangledName = mangle(aggrdecl);
-  if (shouldHashAggrName(mangledName)) {
-    ret += hashSymbolName(mangledName, aggrdecl);
-  } else {
-    ret += mangledName;
-  }
-
-  ret += "6__initZ";
-
-  return gABI->mangleVariableForLLVM(std::move(ret), LINKd);
+  return gABI->mangleVariableForLLVM(getAggrSymbolName(aggrdecl, "6__initZ"),
+                                     LINKd);
 }
 
 std::string getMangledVTableSymbolName(AggregateDeclaration *aggrdecl) {
-  std::string ret = "_D";
-
-  std::string mangledName = mangle(aggrdecl);
-  if (shouldHashAggrName(mangledName)) {
-    ret += hashSymbolName(mangledName, aggrdecl);
-  } else {
-    ret += mangledName;
-  }
-
-  ret += "6__vtblZ";
-
-  return gABI->mangleVariableForLLVM(std::move(ret), LINKd);
+  return gABI->mangleVariableForLLVM(getAggrSymbolName(aggrdecl, "6__vtblZ"),
+                                     LINKd);
 }
 
 std::string getMangledClassInfoSymbolName(AggregateDeclaration *aggrdecl) {
-  std::string ret = "_D";
+  const char *suffix =
+      aggrdecl->isInterfaceDeclaration() ? "11__InterfaceZ" : "7__ClassZ";
+  return gABI->mangleVariableForLLVM(getAggrSymbolName(aggrdecl, suffix),
+                                     LINKd);
+}
 
-  std::string mangledName = mangle(aggrdecl);
-  if (shouldHashAggrName(mangledName)) {
-    ret += hashSymbolName(mangledName, aggrdecl);
-  } else {
-    ret += mangledName;
+void writeHashedSymbolMap(IRState &irs, const char *objectFile) {
+  if (!hashMap || irs.hashedSymbolNames.empty()) {
+    return;
   }
 
-  if (aggrdecl->isInterfaceDeclaration()) {
-    ret += "11__InterfaceZ";
-  } else {
-    ret += "7__ClassZ";
+  llvm::SmallString<128> path(objectFile);
+  llvm::sys::path::replace_extension(path, "symmap");
+  IF_LOG Logger::println("Writing hashed symbol map to: %s", path.c_str());
+
+  LLErrorInfo errinfo;
+  llvm::raw_fd_ostream out(path.c_str(), errinfo, llvm::sys::fs::F_Text);
+  if (out.has_error()) {
+    error(Loc(), "cannot write hashed symbol map '%s': %s", path.c_str(),
+          ERRORINFO_STRING(errinfo));
+    fatal();
   }
 
-  return gABI->mangleVariableForLLVM(std::move(ret), LINKd);
+  // Sort the entries to keep the file reproducible.
+  std::vector<std::pair<llvm::StringRef, llvm::StringRef>> entries;
+  entries.reserve(irs.hashedSymbolNames.size());
+  for (const auto &entry : irs.hashedSymbolNames) {
+    entries.emplace_back(entry.getKey(), entry.getValue());
+  }
+  std::sort(entries.begin(), entries.end());
+
+  for (const auto &entry : entries) {
+    out << entry.first << '\t' << entry.second << '\n';
+  }
 }
@@ -17,6 +17,7 @@
 #include <string>
 #include "ddmd/globals.h"
 
+struct IRState;
 class AggregateDeclaration;
 class FuncDeclaration;
 class VarDeclaration;
@@ -28,4 +29,8 @@ std::string getMangledInitSymbolName(AggregateDeclaration *aggrdecl);
 std::string getMangledVTableSymbolName(AggregateDeclaration *aggrdecl);
 std::string getMangledClassInfoSymbolName(AggregateDeclaration *aggrdecl);
 
+/// Writes the symbol names hashed in the given module, along with their full
+/// names, to <objectFile>.symmap if requested by -hash-map.
+void writeHashedSymbolMap(IRState &irs, const char *objectFile);
+
 #endif // LDC_GEN_MANGLING_H
@@ -21,6 +21,7 @@
 #include "statement.h"
 #include "target.h"
 #include "template.h"
+#include "driver/cl_options.h"
 #include "gen/abi.h"
 #include "gen/arrays.h"
 #include "gen/classes.h"
@@ -35,6 +36,7 @@
 #include "gen/rttibuilder.h"
 #include "gen/runtime.h"
 #include "gen/structs.h"
+#include "gen/targetclones.h"
 #include "gen/tollvm.h"
 #include "ir/irdsymbol.h"
 #include "ir/irfunction.h"
@@ -369,7 +371,7 @@ static void build_dso_ctor_dtor_body(
     llvm::Value *dsoSlot, llvm::Value *minfoBeg, llvm::Value *minfoEnd,
     llvm::Value *minfoUsedPointer, bool executeWhenInitialized) {
   llvm::Function *const dsoRegistry =
-      getRuntimeFunction(Loc(), gIR->module, "_d_dso_registry");
+      getRuntimeFunction(Loc(), gIR->module, RTFunc::_d_dso_registry);
   llvm::Type *const recordPtrTy =
       dsoRegistry->getFunctionType()->getContainedType(1);
 
@@ -662,7 +664,7 @@ static void addCoverageAnalysis(Module *m) {
 
     // Set up call to _d_cover_register2
     llvm::Function *fn =
-        getRuntimeFunction(Loc(), gIR->module, "_d_cover_register2");
+        getRuntimeFunction(Loc(), gIR->module, RTFunc::_d_cover_register2);
     LLValue *args[] = {DtoConstString(m->srcfile->name->toChars()),
                        d_cover_valid_slice, d_cover_data_slice,
                        DtoConstUbyte(global.params.covPercent)};
@@ -786,6 +788,12 @@ void codegenModule(IRState *irs, Module *m, bool emitFullModuleInfo) {
   for (unsigned k = 0; k < m->members->dim; k++) {
     Dsymbol *dsym = (*m->members)[k];
     assert(dsym);
+    // TypeInfo instances are linkonce_odr and also defined on demand in every
+    // module referencing them, so there's no need to define the ones
+    // requested during semantic analysis up front.
+    if (opts::lazyTypeInfo && dsym->isTypeInfoDeclaration()) {
+      continue;
+    }
     Declaration_codegen(dsym);
   }
 
@@ -793,6 +801,11 @@ void codegenModule(IRState *irs, Module *m, bool emitFullModuleInfo) {
     fatal();
   }
 
+  emitTargetClones(irs);
+  if (global.errors) {
+    fatal();
+  }
+
   // Skip emission of all the additional module metadata if requested by the
   // user.
   if (!m->noModuleInfo) {
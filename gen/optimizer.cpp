@@ -32,10 +32,19 @@
 #endif
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Regex.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/DiagnosticPrinter.h"
 #include "llvm/IR/LegacyPassNameParser.h"
 #include "llvm/Transforms/Instrumentation.h"
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#if LDC_LLVM_VER >= 400
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/YAMLTraits.h"
+#endif
 
 extern llvm::TargetMachine *gTargetMachine;
 using namespace llvm;
@@ -84,6 +93,11 @@ static cl::opt<bool> disableGCToStack(
     cl::desc("Disable promotion of GC allocations to stack memory"),
     cl::ZeroOrMore);
 
+static cl::opt<bool> disableCombineAppends(
+    "disable-combine-appends",
+    cl::desc("Disable batching of appends to dynamic arrays"),
+    cl::ZeroOrMore);
+
 static cl::opt<cl::boolOrDefault, false, opts::FlagParser<cl::boolOrDefault>>
     enableInlining(
         "inlining",
@@ -113,6 +127,36 @@ cl::opt<opts::SanitizerCheck> opts::sanitize(
                clEnumValN(opts::ThreadSanitizer, "thread", "race detection"),
                clEnumValEnd));
 
+cl::opt<std::string> opts::usefileSampleProf(
+    "fprofile-sample-use", cl::value_desc("filename"),
+    cl::desc("Use sampling profile data (e.g. converted from perf samples) "
+             "for profile-guided optimization; implies -g"),
+    cl::ValueRequired);
+
+cl::opt<std::string> opts::saveOptimizationRecord(
+    "fsave-optimization-record", cl::value_desc("filename"),
+    cl::desc("Write the optimization remarks in YAML format to <filename> "
+             "(default: <object file>.opt.yaml) (LLVM >= 4.0)"),
+    cl::ValueOptional);
+
+cl::opt<std::string> opts::remarksPassed(
+    "Rpass", cl::value_desc("regex"),
+    cl::desc("Report transformations done by optimization passes whose name "
+             "matches <regex> (LLVM >= 3.9)"));
+
+cl::opt<std::string> opts::remarksMissed(
+    "Rpass-missed", cl::value_desc("regex"),
+    cl::desc("Report transformations missed by optimization passes whose "
+             "name matches <regex> (LLVM >= 3.9)"));
+
+cl::opt<std::string> opts::remarksAnalysis(
+    "Rpass-analysis", cl::value_desc("regex"),
+    cl::desc("Report the analysis results of optimization passes whose name "
+             "matches <regex>, e.g., why a loop wasn't vectorized "
+             "(LLVM >= 3.9)"));
+
+bool opts::debugLocationsOnly = false;
+
 static cl::opt<bool> disableLoopUnrolling(
     "disable-loop-unrolling",
     cl::desc("Disable loop unrolling in all relevant passes"), cl::init(false));
@@ -195,6 +239,13 @@ static void addGarbageCollect2StackPass(const PassManagerBuilder &builder,
   }
 }
 
+static void addCombineArrayAppendsPass(const PassManagerBuilder &builder,
+                                       PassManagerBase &pm) {
+  if (builder.OptLevel >= 2 && builder.SizeLevel == 0) {
+    addPass(pm, createCombineArrayAppends());
+  }
+}
+
 static void addAddressSanitizerPasses(const PassManagerBuilder &Builder,
                                       PassManagerBase &PM) {
   PM.add(createAddressSanitizerFunctionPass());
@@ -223,6 +274,13 @@ static void addThreadSanitizerPass(const PassManagerBuilder &Builder,
   PM.add(createThreadSanitizerPass());
 }
 
+#if LDC_LLVM_VER < 309
+static void addSampleProfileLoaderPass(const PassManagerBuilder &builder,
+                                       PassManagerBase &pm) {
+  pm.add(createSampleProfileLoaderPass(opts::usefileSampleProf));
+}
+#endif
+
 static void addInstrProfilingPass(legacy::PassManagerBase &mpm) {
 #if LDC_WITH_PGO
   if (global.params.genInstrProf) {
@@ -325,6 +383,11 @@ static void addOptimizationPasses(PassManagerBase &mpm,
       builder.addExtension(PassManagerBuilder::EP_LoopOptimizerEnd,
                            addGarbageCollect2StackPass);
     }
+
+    if (!disableCombineAppends) {
+      builder.addExtension(PassManagerBuilder::EP_LoopOptimizerEnd,
+                           addCombineArrayAppendsPass);
+    }
   }
 
   // EP_OptimizerLast does not exist in LLVM 3.0, add it manually below.
@@ -333,6 +396,17 @@ static void addOptimizationPasses(PassManagerBase &mpm,
 
   addInstrProfilingPass(mpm);
 
+  // The sample profile is matched to the IR via the debug line info, so load
+  // it before any other transformation.
+  if (!opts::usefileSampleProf.empty()) {
+#if LDC_LLVM_VER >= 309
+    mpm.add(createSampleProfileLoaderPass(opts::usefileSampleProf));
+#else
+    builder.addExtension(PassManagerBuilder::EP_EarlyAsPossible,
+                         addSampleProfileLoaderPass);
+#endif
+  }
+
   builder.populateFunctionPassManager(fpm);
   builder.populateModulePassManager(mpm);
 }
@@ -451,3 +525,177 @@ void verifyModule(llvm::Module *m) {
   }
   Logger::println("Verification passed!");
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// Optimization remarks
+
+bool willEmitOptimizationRemarks() {
+  return opts::saveOptimizationRecord.getNumOccurrences() > 0 ||
+         !opts::remarksPassed.empty() || !opts::remarksMissed.empty() ||
+         !opts::remarksAnalysis.empty();
+}
+
+#if LDC_LLVM_VER >= 309
+namespace {
+struct RemarkFilter {
+  const char *option;
+  std::unique_ptr<Regex> regex;
+
+  void init(const char *option, const std::string &pattern) {
+    this->option = option;
+    if (pattern.empty()) {
+      return;
+    }
+    regex = llvm::make_unique<Regex>(pattern);
+    std::string regexError;
+    if (!regex->isValid(regexError)) {
+      error(Loc(), "invalid regular expression '%s' for -%s: %s",
+            pattern.c_str(), option, regexError.c_str());
+      regex.reset();
+    }
+  }
+};
+
+RemarkFilter remarksPassedFilter;
+RemarkFilter remarksMissedFilter;
+RemarkFilter remarksAnalysisFilter;
+
+RemarkFilter *getRemarkFilter(const DiagnosticInfo &di) {
+  switch (di.getKind()) {
+  case DK_OptimizationRemark:
+    return &remarksPassedFilter;
+  case DK_OptimizationRemarkMissed:
+    return &remarksMissedFilter;
+  case DK_OptimizationRemarkAnalysis:
+  case DK_OptimizationRemarkAnalysisFPCommute:
+  case DK_OptimizationRemarkAnalysisAliasing:
+    return &remarksAnalysisFilter;
+  default:
+    return nullptr;
+  }
+}
+
+/// Prints an optimization remark like a compiler message, i.e., with the D
+/// source location (if the code has a debug location).
+void printRemark(const DiagnosticInfoOptimizationBase &remark,
+                 const char *option) {
+#if LDC_LLVM_VER >= 400
+  const std::string msg = remark.getMsg();
+#else
+  const std::string msg = remark.getMsg().str();
+#endif
+  if (remark.isLocationAvailable()) {
+    StringRef file;
+    unsigned line, column;
+    remark.getLocation(&file, &line, &column);
+    fprintf(stderr, "%s(%u,%u): Remark: %s [-%s=%s]\n", file.str().c_str(),
+            line, column, msg.c_str(), option, remark.getPassName());
+  } else {
+    fprintf(stderr, "%s: Remark: %s [-%s=%s]\n",
+            remark.getFunction().getName().str().c_str(), msg.c_str(), option,
+            remark.getPassName());
+  }
+}
+
+void diagnosticHandler(const DiagnosticInfo &di, void *) {
+  if (RemarkFilter *filter = getRemarkFilter(di)) {
+    const auto &remark =
+        static_cast<const DiagnosticInfoOptimizationBase &>(di);
+    // Also respect LLVM's own -pass-remarks* options.
+    if ((filter->regex && filter->regex->match(remark.getPassName())) ||
+        remark.isEnabled()) {
+      printRemark(remark, filter->option);
+    }
+    return;
+  }
+
+  // Print all other diagnostics like LLVM does without a handler (see
+  // LLVMContext::diagnose()).
+  const char *prefix = "error";
+  switch (di.getSeverity()) {
+  case DS_Error:
+    break;
+  case DS_Warning:
+    prefix = "warning";
+    break;
+  case DS_Remark:
+    prefix = "remark";
+    break;
+  case DS_Note:
+    prefix = "note";
+    break;
+  }
+  DiagnosticPrinterRawOStream printer(errs());
+  errs() << prefix << ": ";
+  di.print(printer);
+  errs() << "\n";
+  if (di.getSeverity() == DS_Error) {
+    exit(1);
+  }
+}
+}
+#endif
+
+void setupOptimizationRemarks(LLVMContext &context) {
+#if LDC_LLVM_VER >= 309
+  if (opts::remarksPassed.empty() && opts::remarksMissed.empty() &&
+      opts::remarksAnalysis.empty()) {
+    return;
+  }
+
+  remarksPassedFilter.init("Rpass", opts::remarksPassed);
+  remarksMissedFilter.init("Rpass-missed", opts::remarksMissed);
+  remarksAnalysisFilter.init("Rpass-analysis", opts::remarksAnalysis);
+
+  // Get all remarks, they are filtered by the handler.
+  context.setDiagnosticHandler(diagnosticHandler, nullptr,
+                               /*RespectFilters=*/false);
+#endif
+}
+
+#if LDC_LLVM_VER >= 400
+static std::unique_ptr<tool_output_file> optimizationRecordFile;
+#endif
+
+void startOptimizationRecord(llvm::Module &m, const std::string &objectFile) {
+#if LDC_LLVM_VER >= 400
+  if (!opts::saveOptimizationRecord.getNumOccurrences()) {
+    return;
+  }
+
+  SmallString<128> path(opts::saveOptimizationRecord);
+  if (path.empty()) {
+    path = objectFile;
+    sys::path::replace_extension(path, "opt.yaml");
+  }
+
+  std::error_code ec;
+  optimizationRecordFile =
+      llvm::make_unique<tool_output_file>(path, ec, sys::fs::F_Text);
+  if (ec) {
+    error(Loc(), "cannot write optimization record '%s': %s", path.c_str(),
+          ec.message().c_str());
+    fatal();
+  }
+
+  LLVMContext &context = m.getContext();
+  context.setDiagnosticsOutputFile(
+      llvm::make_unique<yaml::Output>(optimizationRecordFile->os()));
+  // Annotate the remarks with the execution counts if a profile is used.
+  if (global.params.datafileInstrProf && !global.params.genInstrProf) {
+    context.setDiagnosticHotnessRequested(true);
+  }
+#endif
+}
+
+void finishOptimizationRecord(llvm::Module &m) {
+#if LDC_LLVM_VER >= 400
+  if (!optimizationRecordFile) {
+    return;
+  }
+
+  m.getContext().setDiagnosticsOutputFile(nullptr);
+  optimizationRecordFile->keep();
+  optimizationRecordFile.reset();
+#endif
+}
@@ -19,6 +19,7 @@
 #include "llvm/Support/CodeGen.h"
 
 #include "llvm/Support/CommandLine.h"
+#include <string>
 
 namespace opts {
 
@@ -30,9 +31,22 @@ enum SanitizerCheck {
 };
 
 extern llvm::cl::opt<SanitizerCheck> sanitize;
+
+extern llvm::cl::opt<std::string> usefileSampleProf;
+
+extern llvm::cl::opt<std::string> saveOptimizationRecord;
+extern llvm::cl::opt<std::string> remarksPassed;
+extern llvm::cl::opt<std::string> remarksMissed;
+extern llvm::cl::opt<std::string> remarksAnalysis;
+
+// Set if debug info is only generated for the source locations of
+// optimization remarks and sample profiles, i.e., without emitting any debug
+// sections.
+extern bool debugLocationsOnly;
 }
 
 namespace llvm {
+class LLVMContext;
 class Module;
 }
 
@@ -49,4 +63,17 @@ llvm::CodeGenOpt::Level codeGenOptLevel();
 
 void verifyModule(llvm::Module *m);
 
+// Returns whether optimization remarks are to be reported (-Rpass*) or saved
+// (-fsave-optimization-record).
+bool willEmitOptimizationRemarks();
+
+// Installs a diagnostic handler reporting the optimization remarks selected
+// by -Rpass* with D source locations.
+void setupOptimizationRemarks(llvm::LLVMContext &context);
+
+// Starts/finishes writing the optimization remarks for the given module to a
+// YAML file, if requested by -fsave-optimization-record.
+void startOptimizationRecord(llvm::Module &m, const std::string &objectFile);
+void finishOptimizationRecord(llvm::Module &m);
+
 #endif
@@ -0,0 +1,472 @@
+//===-- CombineArrayAppends.cpp - Batch appends to dynamic arrays ---------===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Each `arr ~= x` is lowered to a _d_arrayappendcTX(ti, &arr, 1) call (a GC
+// block info lookup, a capacity check and possibly a reallocation), followed
+// by the store of the new element. This pass
+//
+//  * merges straight-line runs of such appends to the same array into a
+//    single _d_arrayappendcTX(ti, &arr, n) call, and
+//  * reserves the final capacity once before counted loops appending a fixed
+//    number of elements per iteration, so that the appends in the loop take
+//    the runtime's in-place fast path.
+//
+// The appends in loops are kept as runtime calls, as the runtime needs to
+// track the used length of the GC block to prevent other slices of it from
+// stomping over the appended elements.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "dcombine-appends"
+
+#include "Passes.h"
+#include "llvm/Pass.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/ValueTracking.h"
+#if LDC_LLVM_VER >= 308
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/ScalarEvolutionExpander.h"
+#endif
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+
+#if LDC_LLVM_VER >= 308
+typedef AAResultsWrapperPass AliasAnalysisPass;
+#else
+typedef AliasAnalysis AliasAnalysisPass;
+#endif
+
+#if LDC_LLVM_VER >= 307
+static const uint64_t UnknownSize = MemoryLocation::UnknownSize;
+#else
+static const uint64_t UnknownSize = AliasAnalysis::UnknownSize;
+#endif
+
+STATISTIC(NumMerged, "Number of appends merged into a preceding append");
+STATISTIC(NumReserved, "Number of loops with appends reserving capacity");
+
+static const char *const AppendFnName = "_d_arrayappendcTX";
+
+namespace {
+class LLVM_LIBRARY_VISIBILITY CombineArrayAppends : public FunctionPass {
+  const DataLayout *DL;
+  AliasAnalysis *AA;
+
+  bool combineAppends(BasicBlock &BB);
+#if LDC_LLVM_VER >= 308
+  bool reserveForLoop(Loop *L, LoopInfo &LI, DominatorTree &DT,
+                      ScalarEvolution &SE);
+#endif
+
+public:
+  static char ID; // Pass identification
+  CombineArrayAppends() : FunctionPass(ID) {}
+
+  bool runOnFunction(Function &F) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+#if LDC_LLVM_VER < 307
+    AU.addRequired<DataLayoutPass>();
+#endif
+    AU.addRequired<AliasAnalysisPass>();
+#if LDC_LLVM_VER >= 308
+    AU.addRequired<DominatorTreeWrapperPass>();
+    AU.addRequired<LoopInfoWrapperPass>();
+    AU.addRequired<ScalarEvolutionWrapperPass>();
+    AU.addPreserved<DominatorTreeWrapperPass>();
+    AU.addPreserved<LoopInfoWrapperPass>();
+#endif
+  }
+};
+char CombineArrayAppends::ID = 0;
+} // end anonymous namespace.
+
+static RegisterPass<CombineArrayAppends>
+    X("dcombine-appends", "Batch appends to D dynamic arrays");
+
+// Public interface to the pass.
+FunctionPass *createCombineArrayAppends() { return new CombineArrayAppends(); }
+
+//===----------------------------------------------------------------------===//
+// Helper functions
+//===----------------------------------------------------------------------===//
+
+/// Returns the call if I is a plain (non-invoke) call to _d_arrayappendcTX.
+static CallInst *asAppendCall(Instruction *I) {
+  auto CI = dyn_cast<CallInst>(I);
+  if (!CI) {
+    return nullptr;
+  }
+  Function *Callee = CI->getCalledFunction();
+  if (!Callee || Callee->getName() != AppendFnName ||
+      CI->getNumArgOperands() != 3) {
+    return nullptr;
+  }
+  return CI;
+}
+
+static Value *getTypeInfo(CallInst *Append) {
+  return Append->getArgOperand(0)->stripPointerCasts();
+}
+
+static Value *getArray(CallInst *Append) {
+  return Append->getArgOperand(1)->stripPointerCasts();
+}
+
+static Value *getPointerBase(Value *Ptr, int64_t &Offset,
+                             const DataLayout &DL) {
+#if LDC_LLVM_VER >= 307
+  return GetPointerBaseWithConstantOffset(Ptr, Offset, DL);
+#else
+  return GetPointerBaseWithConstantOffset(Ptr, Offset, &DL);
+#endif
+}
+
+namespace {
+enum class SliceField { None, Length, Ptr };
+}
+
+/// Checks whether V is a load of the length or ptr field of the slice at Arr.
+static SliceField getSliceFieldLoad(Value *V, Value *Arr,
+                                    const DataLayout &DL) {
+  auto LI = dyn_cast<LoadInst>(V->stripPointerCasts());
+  if (!LI || !LI->isSimple()) {
+    return SliceField::None;
+  }
+  int64_t Offset = 0;
+  Value *Base = getPointerBase(LI->getPointerOperand(), Offset, DL);
+  if (Base->stripPointerCasts() != Arr) {
+    return SliceField::None;
+  }
+  if (Offset == 0 && LI->getType()->isIntegerTy()) {
+    return SliceField::Length;
+  }
+  if (Offset == DL.getPointerSize() && LI->getType()->isPointerTy()) {
+    return SliceField::Ptr;
+  }
+  return SliceField::None;
+}
+
+/// Checks whether Ptr points into the elements of the array at Arr. The
+/// elements of a T[] can't overlap a T[] slice itself (short of casts
+/// reinterpreting the memory), so accessing them doesn't change the array.
+static bool isElementPointer(Value *Ptr, Value *Arr, const DataLayout &DL) {
+#if LDC_LLVM_VER >= 307
+  Value *Obj = GetUnderlyingObject(Ptr, DL);
+#else
+  Value *Obj = GetUnderlyingObject(Ptr, &DL);
+#endif
+  return getSliceFieldLoad(Obj, Arr, DL) == SliceField::Ptr;
+}
+
+static bool mayAlias(AliasAnalysis &AA, Value *V1, uint64_t Size1, Value *V2,
+                     uint64_t Size2) {
+#if LDC_LLVM_VER >= 307
+  return AA.alias(V1, Size1, V2, Size2) != NoAlias;
+#else
+  return AA.alias(V1, Size1, V2, Size2) != AliasAnalysis::NoAlias;
+#endif
+}
+
+/// Checks whether a memory access to Ptr may change the slice at Arr or read
+/// it.
+static bool mayAccessSlice(AliasAnalysis &AA, const DataLayout &DL,
+                           Value *Ptr, uint64_t Size, Value *Arr) {
+  return !isElementPointer(Ptr, Arr, DL) &&
+         mayAlias(AA, Ptr, Size, Arr, 2 * DL.getPointerSize());
+}
+
+//===----------------------------------------------------------------------===//
+// Merging of straight-line appends
+//===----------------------------------------------------------------------===//
+
+/// Merges
+///
+///   len1 = arr.length; _d_arrayappendcTX(ti, &arr, n1); arr.ptr[len1] = x;
+///   len2 = arr.length; _d_arrayappendcTX(ti, &arr, n2); arr.ptr[len2] = y;
+///
+/// into a single _d_arrayappendcTX(ti, &arr, n1 + n2), rewriting len2 to
+/// `arr.length - n2`, as long as nothing in between may access the slice (the
+/// length/ptr pair) otherwise or throw.
+bool CombineArrayAppends::combineAppends(BasicBlock &BB) {
+  bool Changed = false;
+
+  // The append the following ones can be merged into.
+  CallInst *First = nullptr;
+  // The loads of the array length after First, together with the adjustment
+  // for the elements appended by merged calls.
+  SmallVector<std::pair<LoadInst *, BinaryOperator *>, 4> LengthLoads;
+
+  for (auto It = BB.begin(), E = BB.end(); It != E;) {
+    Instruction *I = &*It++;
+
+    if (CallInst *Append = asAppendCall(I)) {
+      auto N = dyn_cast<ConstantInt>(Append->getArgOperand(2));
+      if (First && N && Append->use_empty() &&
+          getArray(Append) == getArray(First) &&
+          getTypeInfo(Append) == getTypeInfo(First)) {
+        DEBUG(errs() << "CombineArrayAppends merging: " << *Append << '\n');
+
+        // Append all elements with the first call.
+        auto FirstN = cast<ConstantInt>(First->getArgOperand(2));
+        First->setArgOperand(2, ConstantExpr::getAdd(FirstN, N));
+
+        // Loads of the length in between now see the N elements more.
+        for (auto &Entry : LengthLoads) {
+          LoadInst *Len = Entry.first;
+          Constant *Adjustment =
+              ConstantExpr::getZExtOrBitCast(N, Len->getType());
+          if (BinaryOperator *Sub = Entry.second) {
+            Sub->setOperand(1, ConstantExpr::getAdd(
+                                   cast<Constant>(Sub->getOperand(1)),
+                                   Adjustment));
+          } else {
+            auto NewSub = BinaryOperator::CreateSub(Len, Adjustment,
+                                                    Len->getName() + ".adj");
+            NewSub->insertAfter(Len);
+            Len->replaceAllUsesWith(NewSub);
+            NewSub->setOperand(0, Len);
+            Entry.second = NewSub;
+          }
+        }
+
+        emitDPassRemark(DEBUG_TYPE, Append,
+                        "merged append into a preceding one to the same "
+                        "array");
+        Append->eraseFromParent();
+        ++NumMerged;
+        Changed = true;
+        continue;
+      }
+
+      // Start a new run, unless the result of the call is used (it would
+      // include the elements of merged calls).
+      First = (N && Append->use_empty()) ? Append : nullptr;
+      LengthLoads.clear();
+      continue;
+    }
+
+    if (!First) {
+      continue;
+    }
+
+    Value *Arr = getArray(First);
+    bool Interferes = false;
+    if (auto LI = dyn_cast<LoadInst>(I)) {
+      switch (getSliceFieldLoad(LI, Arr, *DL)) {
+      case SliceField::Length:
+        LengthLoads.push_back(std::make_pair(LI, nullptr));
+        break;
+      case SliceField::Ptr:
+        break;
+      case SliceField::None:
+        Interferes = !LI->isSimple() ||
+                     mayAccessSlice(*AA, *DL, LI->getPointerOperand(),
+                                    DL->getTypeStoreSize(LI->getType()), Arr);
+        break;
+      }
+    } else if (auto SI = dyn_cast<StoreInst>(I)) {
+      Interferes =
+          !SI->isSimple() ||
+          mayAccessSlice(*AA, *DL, SI->getPointerOperand(),
+                         DL->getTypeStoreSize(SI->getValueOperand()->getType()),
+                         Arr);
+    } else if (isa<DbgInfoIntrinsic>(I)) {
+      // Ignore.
+    } else if (auto MI = dyn_cast<MemIntrinsic>(I)) {
+      auto Len = dyn_cast<ConstantInt>(MI->getLength());
+      const uint64_t Size = Len ? Len->getZExtValue() : UnknownSize;
+      Interferes = MI->isVolatile() ||
+                   mayAccessSlice(*AA, *DL, MI->getRawDest(), Size, Arr);
+      if (auto MTI = dyn_cast<MemTransferInst>(MI)) {
+        Interferes = Interferes ||
+                     mayAccessSlice(*AA, *DL, MTI->getRawSource(), Size, Arr);
+      }
+    } else {
+      // Other calls (e.g., postblits) may access the array or throw, and
+      // there's no telling what other memory accesses do.
+      Interferes = I->mayReadOrWriteMemory() || I->mayThrow();
+    }
+
+    if (Interferes) {
+      First = nullptr;
+      LengthLoads.clear();
+    }
+  }
+
+  return Changed;
+}
+
+//===----------------------------------------------------------------------===//
+// Capacity reservation for appends in counted loops
+//===----------------------------------------------------------------------===//
+
+#if LDC_LLVM_VER >= 308
+/// Checks whether a call throwing in a loop is fatal (failed asserts and
+/// bounds checks throw Errors), i.e., doesn't just leave the loop early.
+static bool isFatalErrorCall(CallSite CS) {
+  Function *Callee = CS.getCalledFunction();
+  return Callee && CS.doesNotReturn() &&
+         (Callee->getName().startswith("_d_assert") ||
+          Callee->getName() == "_d_arraybounds");
+}
+
+/// Reserves the final capacity in the preheader of a loop with a computable
+/// trip count, appending a constant number of elements in every iteration.
+/// The loop must not be left early (apart from fatal errors), so that the
+/// reserved memory is actually used.
+bool CombineArrayAppends::reserveForLoop(Loop *L, LoopInfo &LI,
+                                         DominatorTree &DT,
+                                         ScalarEvolution &SE) {
+  BasicBlock *Preheader = L->getLoopPreheader();
+  BasicBlock *Latch = L->getLoopLatch();
+  if (!Preheader || !Latch || L->getExitingBlock() != Latch) {
+    return false;
+  }
+
+  const SCEV *BTC = SE.getBackedgeTakenCount(L);
+  if (isa<SCEVCouldNotCompute>(BTC) || !isSafeToExpand(BTC, SE)) {
+    return false;
+  }
+  // Not worth it for a single iteration.
+  if (BTC->isZero()) {
+    return false;
+  }
+
+  // The number of elements appended in every iteration, per (TypeInfo,
+  // array) pair.
+  typedef std::pair<Value *, Value *> Key;
+  MapVector<Key, std::pair<CallInst *, uint64_t>> Appends;
+
+  for (BasicBlock *BB : L->blocks()) {
+    for (auto &I : *BB) {
+      CallSite CS(&I);
+      if (!CS || isa<IntrinsicInst>(I)) {
+        continue;
+      }
+
+      if (CallInst *Append = asAppendCall(&I)) {
+        auto N = dyn_cast<ConstantInt>(Append->getArgOperand(2));
+        // Only count the appends executed exactly once per iteration.
+        if (N && LI.getLoopFor(BB) == L && DT.dominates(BB, Latch) &&
+            L->isLoopInvariant(getTypeInfo(Append)) &&
+            L->isLoopInvariant(getArray(Append))) {
+          auto &Entry = Appends[Key(getTypeInfo(Append), getArray(Append))];
+          Entry.first = Append;
+          Entry.second += N->getZExtValue();
+        }
+        continue;
+      }
+
+      if (!CS.doesNotThrow() && !isFatalErrorCall(CS)) {
+        return false;
+      }
+    }
+  }
+
+  if (Appends.empty()) {
+    return false;
+  }
+
+  Instruction *InsertPt = Preheader->getTerminator();
+  IRBuilder<> B(InsertPt);
+  SCEVExpander Expander(SE, *DL, "reserve");
+  Module &M = *Preheader->getParent()->getParent();
+
+  for (auto &Entry : Appends) {
+    Value *TI = Entry.first.first;
+    Value *Arr = Entry.first.second;
+    CallInst *Append = Entry.second.first;
+    const uint64_t PerIteration = Entry.second.second;
+    Type *SizeTy = Append->getArgOperand(2)->getType();
+
+    DEBUG(errs() << "CombineArrayAppends reserving for: " << *Append << '\n');
+
+    // size_t _d_arraysetcapacity(const TypeInfo ti, size_t newcapacity,
+    //                            void[]* p)
+    Type *Params[] = {Append->getArgOperand(0)->getType(), SizeTy,
+                      Append->getArgOperand(1)->getType()};
+    auto FT = FunctionType::get(SizeTy, Params, false);
+    Constant *SetCapacity = M.getOrInsertFunction("_d_arraysetcapacity", FT);
+
+    const SCEV *TripCount =
+        SE.getAddExpr(SE.getTruncateOrZeroExtend(BTC, SizeTy),
+                      SE.getConstant(SizeTy, 1));
+    Value *Trip = Expander.expandCodeFor(TripCount, SizeTy, InsertPt);
+    Value *Len = B.CreateLoad(B.CreateBitCast(Arr, SizeTy->getPointerTo()),
+                              "reserve.len");
+    Value *NewCapacity = B.CreateAdd(
+        Len, B.CreateMul(Trip, ConstantInt::get(SizeTy, PerIteration)),
+        "reserve.cap");
+    Value *Args[] = {B.CreateBitCast(TI, Params[0]), NewCapacity,
+                     B.CreateBitCast(Arr, Params[2])};
+    B.CreateCall(SetCapacity, Args);
+
+    emitDPassRemark(DEBUG_TYPE, Append,
+                    "reserved the capacity for the appends in the loop");
+    ++NumReserved;
+  }
+
+  return true;
+}
+#endif
+
+//===----------------------------------------------------------------------===//
+// Pass entry point
+//===----------------------------------------------------------------------===//
+
+bool CombineArrayAppends::runOnFunction(Function &F) {
+#if LDC_LLVM_VER >= 307
+  DL = &F.getParent()->getDataLayout();
+#else
+  DataLayoutPass *DLP = getAnalysisIfAvailable<DataLayoutPass>();
+  assert(DLP && "required DataLayoutPass is null");
+  DL = &DLP->getDataLayout();
+#endif
+#if LDC_LLVM_VER >= 308
+  AA = &getAnalysis<AliasAnalysisPass>().getAAResults();
+#else
+  AA = &getAnalysis<AliasAnalysisPass>();
+#endif
+
+  bool Changed = false;
+  for (auto &BB : F) {
+    Changed |= combineAppends(BB);
+  }
+
+#if LDC_LLVM_VER >= 308
+  DominatorTree &DT = getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+  LoopInfo &LI = getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+  ScalarEvolution &SE = getAnalysis<ScalarEvolutionWrapperPass>().getSE();
+  SmallVector<Loop *, 8> Worklist(LI.begin(), LI.end());
+  while (!Worklist.empty()) {
+    Loop *L = Worklist.pop_back_val();
+    Worklist.append(L->begin(), L->end());
+    Changed |= reserveForLoop(L, LI, DT, SE);
+  }
+#endif
+
+  return Changed;
+}
@@ -519,6 +519,9 @@ bool GarbageCollect2Stack::runOnFunction(Function &F) {
       FunctionInfo *info = OMI->getValue();
 
       if (Inst->use_empty()) {
+        emitDPassRemark(DEBUG_TYPE, Inst,
+                        Twine("removed unused GC allocation (") +
+                            Callee->getName() + ")");
         Changed = true;
         NumDeleted++;
         RemoveCall(CS, A);
@@ -528,18 +531,26 @@ bool GarbageCollect2Stack::runOnFunction(Function &F) {
       DEBUG(errs() << "GarbageCollect2Stack inspecting: " << *Inst);
 
       if (!info->analyze(CS, A)) {
+        emitDPassRemarkMissed(
+            DEBUG_TYPE, Inst,
+            Twine("GC allocation (") + Callee->getName() +
+                ") not promoted to the stack: unknown or too large size, or "
+                "class with destructor");
         continue;
       }
 
       SmallVector<CallInst *, 4> RemoveTailCallInsts;
-      if (info->ReturnType == ReturnType::Array) {
-        if (!isSafeToStackAllocateArray(originalI, DT, RemoveTailCallInsts)) {
-          continue;
-        }
-      } else {
-        if (!isSafeToStackAllocate(originalI, Inst, DT, RemoveTailCallInsts)) {
-          continue;
-        }
+      const bool isSafe =
+          info->ReturnType == ReturnType::Array
+              ? isSafeToStackAllocateArray(originalI, DT, RemoveTailCallInsts)
+              : isSafeToStackAllocate(originalI, Inst, DT,
+                                      RemoveTailCallInsts);
+      if (!isSafe) {
+        emitDPassRemarkMissed(DEBUG_TYPE, Inst,
+                              Twine("GC allocation (") + Callee->getName() +
+                                  ") not promoted to the stack: the memory "
+                                  "may escape or outlive a loop iteration");
+        continue;
       }
 
       // Let's alloca this!
@@ -563,6 +574,9 @@ bool GarbageCollect2Stack::runOnFunction(Function &F) {
       }
       Inst->replaceAllUsesWith(newVal);
 
+      emitDPassRemark(DEBUG_TYPE, Inst, Twine("GC allocation (") +
+                                            Callee->getName() +
+                                            ") promoted to the stack");
       RemoveCall(CS, A);
     }
   }
@@ -17,7 +17,9 @@
 #include "gen/metadata.h"
 namespace llvm {
 class FunctionPass;
+class Instruction;
 class ModulePass;
+class Twine;
 }
 
 // Performs simplifications on runtime calls.
@@ -25,6 +27,15 @@ llvm::FunctionPass *createSimplifyDRuntimeCalls();
 
 llvm::FunctionPass *createGarbageCollect2Stack();
 
+llvm::FunctionPass *createCombineArrayAppends();
+
 llvm::ModulePass *createStripExternalsPass();
 
+// Report a transformation done/missed by a D-specific pass at the given
+// instruction as optimization remark (-Rpass, -fsave-optimization-record).
+void emitDPassRemark(const char *passName, llvm::Instruction *inst,
+                     const llvm::Twine &msg);
+void emitDPassRemarkMissed(const char *passName, llvm::Instruction *inst,
+                           const llvm::Twine &msg);
+
 #endif
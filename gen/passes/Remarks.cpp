@@ -0,0 +1,50 @@
+//===-- Remarks.cpp - Optimization remarks of the D-specific passes -------===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// The D-specific passes report what they did (and why they didn't) as LLVM
+// optimization remarks, located at the D source of the affected runtime call.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Passes.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instruction.h"
+#if LDC_LLVM_VER >= 400
+#include "llvm/Analysis/OptimizationDiagnosticInfo.h"
+#endif
+
+using namespace llvm;
+
+void emitDPassRemark(const char *passName, Instruction *inst,
+                     const Twine &msg) {
+  Function &F = *inst->getParent()->getParent();
+#if LDC_LLVM_VER >= 400
+  // The emitter also writes the remark to the optimization record.
+  OptimizationRemarkEmitter ORE(&F);
+  ORE.emitOptimizationRemark(passName, inst->getDebugLoc(), inst->getParent(),
+                             msg);
+#else
+  emitOptimizationRemark(F.getContext(), passName, F, inst->getDebugLoc(),
+                         msg);
+#endif
+}
+
+void emitDPassRemarkMissed(const char *passName, Instruction *inst,
+                           const Twine &msg) {
+  Function &F = *inst->getParent()->getParent();
+#if LDC_LLVM_VER >= 400
+  OptimizationRemarkEmitter ORE(&F);
+  ORE.emitOptimizationRemarkMissed(passName, inst->getDebugLoc(),
+                                   inst->getParent(), msg);
+#else
+  emitOptimizationRemarkMissed(F.getContext(), passName, F,
+                               inst->getDebugLoc(), msg);
+#endif
+}
@@ -457,11 +457,16 @@ bool SimplifyDRuntimeCalls::runOnce(Function &F, const DataLayout *DL,
 
       if (Result == CI) {
         assert(CI->use_empty());
+        emitDPassRemark(DEBUG_TYPE, CI, Twine("removed call to ") +
+                                            Callee->getName() +
+                                            " (result unused)");
         ++NumDeleted;
 #if LDC_LLVM_VER < 308
         AA.deleteValue(CI);
 #endif
       } else {
+        emitDPassRemark(DEBUG_TYPE, CI,
+                        Twine("simplified call to ") + Callee->getName());
         ++NumSimplified;
 #if LDC_LLVM_VER < 308
         AA.replaceWithNewValue(CI, Result);
@@ -27,11 +27,10 @@
 #include "mtype.h"
 #include "root.h"
 #include "tokens.h"
-#include "llvm/Bitcode/ReaderWriter.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/CommandLine.h"
-#include "llvm/Support/MemoryBuffer.h"
 
 #include <algorithm>
 
@@ -45,13 +44,6 @@ static llvm::cl::opt<bool> nogc(
 
 ////////////////////////////////////////////////////////////////////////////////
 
-// Internal LLVM module containing runtime declarations (functions and globals)
-static llvm::Module *M = nullptr;
-
-static void buildRuntimeModule();
-
-////////////////////////////////////////////////////////////////////////////////
-
 static void checkForImplicitGCCall(const Loc &loc, const char *name) {
   if (nogc) {
     static const std::string GCNAMES[] = {
@@ -101,82 +93,6 @@ static void checkForImplicitGCCall(const Loc &loc, const char *name) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-bool initRuntime() {
-  Logger::println("*** Initializing D runtime declarations ***");
-  LOG_SCOPE;
-
-  if (!M) {
-    buildRuntimeModule();
-  }
-
-  return true;
-}
-
-void freeRuntime() {
-  if (M) {
-    Logger::println("*** Freeing D runtime declarations ***");
-    delete M;
-    M = nullptr;
-  }
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-llvm::Function *getRuntimeFunction(const Loc &loc, llvm::Module &target,
-                                   const char *name) {
-  checkForImplicitGCCall(loc, name);
-
-  if (!M) {
-    initRuntime();
-  }
-
-  LLFunction *fn = target.getFunction(name);
-  if (fn) {
-    return fn;
-  }
-
-  fn = M->getFunction(name);
-  if (!fn) {
-    error(loc, "Runtime function '%s' was not found", name);
-    fatal();
-  }
-
-  LLFunctionType *fnty = fn->getFunctionType();
-  LLFunction *resfn =
-      llvm::cast<llvm::Function>(target.getOrInsertFunction(name, fnty));
-  resfn->setAttributes(fn->getAttributes());
-  resfn->setCallingConv(fn->getCallingConv());
-  return resfn;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-llvm::GlobalVariable *getRuntimeGlobal(Loc &loc, llvm::Module &target,
-                                       const char *name) {
-  LLGlobalVariable *gv = target.getNamedGlobal(name);
-  if (gv) {
-    return gv;
-  }
-
-  checkForImplicitGCCall(loc, name);
-
-  if (!M) {
-    initRuntime();
-  }
-
-  LLGlobalVariable *g = M->getNamedGlobal(name);
-  if (!g) {
-    error(loc, "Runtime global '%s' was not found", name);
-    fatal();
-    // return NULL;
-  }
-
-  LLPointerType *t = g->getType();
-  return getOrCreateGlobal(loc, target, t->getElementType(), g->isConstant(),
-                           g->getLinkage(), nullptr, g->getName());
-}
-
-////////////////////////////////////////////////////////////////////////////////
 
 // extern (D) alias dg_t = int delegate(void*);
 static Type *rt_dg1() {
@@ -215,471 +131,679 @@ template <typename DECL> static void ensureDecl(DECL *decl, const char *msg) {
   }
 }
 
-// Parameters fnames are assumed to be already mangled!
-static void createFwdDecl(LINK linkage, Type *returntype,
-                          ArrayParam<llvm::StringRef> fnames,
-                          ArrayParam<Type *> paramtypes,
-                          ArrayParam<StorageClass> paramsSTC = {},
-                          AttrSet attribset = AttrSet()) {
+////////////////////////////////////////////////////////////////////////////////
 
-  Parameters *params = nullptr;
-  if (!paramtypes.empty()) {
-    params = new Parameters();
-    for (size_t i = 0, e = paramtypes.size(); i < e; ++i) {
-      StorageClass stc = paramsSTC.empty() ? 0 : paramsSTC[i];
-      params->push(Parameter::create(stc, paramtypes[i], nullptr, nullptr));
-    }
-  }
-  int varargs = 0;
-  auto dty = TypeFunction::create(params, returntype, varargs, linkage);
+namespace {
+// The D types occurring in runtime function signatures.
+enum class RTType {
+  None, // terminates the parameter list
+  Void,
+  Bool,
+  UByte,
+  Int,
+  UInt,
+  ULong,
+  SizeT,
+  DChar,
+  Real80,
+  Complex80,
+  VoidPtr,
+  VoidPtrPtr,
+  VoidArray,
+  VoidArrayPtr,
+  VoidArrayArray,
+  String,
+  WString,
+  DString,
+  StringArray,
+  WStringArray,
+  DStringArray,
+  SizeTArray,
+  UIntArray,
+  Object,
+  ObjectPtr,
+  ClassInfo,
+  TypeInfo,
+  TypeInfoStruct,
+  AATypeInfo,
+  ModuleInfoPtr,
+  AA,
+  AAPtr,
+  Dg1,
+  Dg2
+};
+
+// The attribute lists attached to runtime function declarations.
+enum class RTAttrs {
+  None,
+  NoAlias,
+  NoUnwind,
+  ReadOnly,
+  ReadNone,
+  NonLazyBind,
+  Cold_NoReturn,
+  ReadOnly_NoUnwind,
+  ReadOnly_1_3_NoCapture,
+  ReadOnly_NoUnwind_1_NoCapture,
+  NoCapture_1,
+  NoAlias_1_NoCapture,
+  NoCapture_1_2,
+  NoCapture_1_3,
+  NoCapture_1_4
+};
+
+const unsigned MaxRTParams = 5;
+
+struct RTFunctionDesc {
+  RTFunc::Type id;
+  const char *name; // not yet mangled for LLVM
+  LINK linkage;
+  RTType returnType;
+  RTType paramTypes[MaxRTParams];
+  StorageClass paramsSTC[MaxRTParams];
+  RTAttrs attrs;
+};
+
+// Signatures of all runtime functions known to the compiler, indexed by
+// RTFunc::Type. Declarations are only materialized when first requested.
+const RTFunctionDesc runtimeFunctions[] = {
+    // void _d_assert(string file, uint line)
+    // void _d_arraybounds(string file, uint line)
+    {RTFunc::_d_assert, "_d_assert", LINKc, RTType::Void,
+     {RTType::String, RTType::UInt}, {}, RTAttrs::Cold_NoReturn},
+    {RTFunc::_d_arraybounds, "_d_arraybounds", LINKc, RTType::Void,
+     {RTType::String, RTType::UInt}, {}, RTAttrs::Cold_NoReturn},
+
+    // void _d_assert_msg(string msg, string file, uint line)
+    {RTFunc::_d_assert_msg, "_d_assert_msg", LINKc, RTType::Void,
+     {RTType::String, RTType::String, RTType::UInt}, {},
+     RTAttrs::Cold_NoReturn},
+
+    // void _d_assertm(immutable(ModuleInfo)* m, uint line)
+    // void _d_array_bounds(immutable(ModuleInfo)* m, uint line)
+    // void _d_switch_error(immutable(ModuleInfo)* m, uint line)
+    {RTFunc::_d_assertm, "_d_assertm", LINKc, RTType::Void,
+     {RTType::ModuleInfoPtr, RTType::UInt}, {STCimmutable, 0},
+     RTAttrs::Cold_NoReturn},
+    {RTFunc::_d_array_bounds, "_d_array_bounds", LINKc, RTType::Void,
+     {RTType::ModuleInfoPtr, RTType::UInt}, {STCimmutable, 0},
+     RTAttrs::Cold_NoReturn},
+    {RTFunc::_d_switch_error, "_d_switch_error", LINKc, RTType::Void,
+     {RTType::ModuleInfoPtr, RTType::UInt}, {STCimmutable, 0},
+     RTAttrs::Cold_NoReturn},
+
+    ////////////////////////////////////////////////////////////////////////////
+
+    // void* _d_allocmemory(size_t sz)
+    {RTFunc::_d_allocmemory, "_d_allocmemory", LINKc, RTType::VoidPtr,
+     {RTType::SizeT}, {}, RTAttrs::NoAlias},
+
+    // void* _d_allocmemoryT(TypeInfo ti)
+    {RTFunc::_d_allocmemoryT, "_d_allocmemoryT", LINKc, RTType::VoidPtr,
+     {RTType::TypeInfo}, {}, RTAttrs::NoAlias},
+
+    // void[] _d_newarrayT (const TypeInfo ti, size_t length)
+    // void[] _d_newarrayiT(const TypeInfo ti, size_t length)
+    // void[] _d_newarrayU (const TypeInfo ti, size_t length)
+    {RTFunc::_d_newarrayT, "_d_newarrayT", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::SizeT}, {STCconst, 0}, RTAttrs::None},
+    {RTFunc::_d_newarrayiT, "_d_newarrayiT", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::SizeT}, {STCconst, 0}, RTAttrs::None},
+    {RTFunc::_d_newarrayU, "_d_newarrayU", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::SizeT}, {STCconst, 0}, RTAttrs::None},
+
+    // void[] _d_newarraymTX (const TypeInfo ti, size_t[] dims)
+    // void[] _d_newarraymiTX(const TypeInfo ti, size_t[] dims)
+    {RTFunc::_d_newarraymTX, "_d_newarraymTX", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::SizeTArray}, {STCconst, 0}, RTAttrs::None},
+    {RTFunc::_d_newarraymiTX, "_d_newarraymiTX", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::SizeTArray}, {STCconst, 0}, RTAttrs::None},
+
+    // void[] _d_arraysetlengthT (const TypeInfo ti, size_t newlength,
+    //                            void[]* p)
+    // void[] _d_arraysetlengthiT(const TypeInfo ti, size_t newlength,
+    //                            void[]* p)
+    {RTFunc::_d_arraysetlengthT, "_d_arraysetlengthT", LINKc,
+     RTType::VoidArray,
+     {RTType::TypeInfo, RTType::SizeT, RTType::VoidArrayPtr},
+     {STCconst, 0, 0}, RTAttrs::None},
+    {RTFunc::_d_arraysetlengthiT, "_d_arraysetlengthiT", LINKc,
+     RTType::VoidArray,
+     {RTType::TypeInfo, RTType::SizeT, RTType::VoidArrayPtr},
+     {STCconst, 0, 0}, RTAttrs::None},
+
+    // byte[] _d_arrayappendcTX(const TypeInfo ti, ref byte[] px, size_t n)
+    {RTFunc::_d_arrayappendcTX, "_d_arrayappendcTX", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::VoidArray, RTType::SizeT},
+     {STCconst, STCref, 0}, RTAttrs::None},
+
+    // void[] _d_arrayappendT(const TypeInfo ti, ref byte[] x, byte[] y)
+    {RTFunc::_d_arrayappendT, "_d_arrayappendT", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::VoidArray, RTType::VoidArray},
+     {STCconst, STCref, 0}, RTAttrs::None},
+
+    // void[] _d_arrayappendcd(ref byte[] x, dchar c)
+    // void[] _d_arrayappendwd(ref byte[] x, dchar c)
+    {RTFunc::_d_arrayappendcd, "_d_arrayappendcd", LINKc, RTType::VoidArray,
+     {RTType::VoidArray, RTType::DChar}, {STCref, 0}, RTAttrs::None},
+    {RTFunc::_d_arrayappendwd, "_d_arrayappendwd", LINKc, RTType::VoidArray,
+     {RTType::VoidArray, RTType::DChar}, {STCref, 0}, RTAttrs::None},
+
+    // byte[] _d_arraycatT(const TypeInfo ti, byte[] x, byte[] y)
+    {RTFunc::_d_arraycatT, "_d_arraycatT", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::VoidArray, RTType::VoidArray},
+     {STCconst, 0, 0}, RTAttrs::None},
+
+    // void[] _d_arraycatnTX(const TypeInfo ti, byte[][] arrs)
+    {RTFunc::_d_arraycatnTX, "_d_arraycatnTX", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::VoidArrayArray}, {STCconst, 0},
+     RTAttrs::None},
+
+    // Object _d_newclass(const ClassInfo ci)
+    {RTFunc::_d_newclass, "_d_newclass", LINKc, RTType::Object,
+     {RTType::ClassInfo}, {STCconst}, RTAttrs::NoAlias},
+
+    // void* _d_newitemT (TypeInfo ti)
+    // void* _d_newitemiT(TypeInfo ti)
+    {RTFunc::_d_newitemT, "_d_newitemT", LINKc, RTType::VoidPtr,
+     {RTType::TypeInfo}, {0}, RTAttrs::NoAlias},
+    {RTFunc::_d_newitemiT, "_d_newitemiT", LINKc, RTType::VoidPtr,
+     {RTType::TypeInfo}, {0}, RTAttrs::NoAlias},
+
+    // void _d_delarray_t(void[]* p, const TypeInfo_Struct ti)
+    {RTFunc::_d_delarray_t, "_d_delarray_t", LINKc, RTType::Void,
+     {RTType::VoidArrayPtr, RTType::TypeInfoStruct}, {0, STCconst},
+     RTAttrs::None},
+
+    // void _d_delmemory(void** p)
+    // void _d_delinterface(void** p)
+    {RTFunc::_d_delmemory, "_d_delmemory", LINKc, RTType::Void,
+     {RTType::VoidPtrPtr}, {}, RTAttrs::None},
+    {RTFunc::_d_delinterface, "_d_delinterface", LINKc, RTType::Void,
+     {RTType::VoidPtrPtr}, {}, RTAttrs::None},
+
+    // void _d_callfinalizer(void* p)
+    {RTFunc::_d_callfinalizer, "_d_callfinalizer", LINKc, RTType::Void,
+     {RTType::VoidPtr}, {}, RTAttrs::None},
+
+    // D2: void _d_delclass(Object* p)
+    {RTFunc::_d_delclass, "_d_delclass", LINKc, RTType::Void,
+     {RTType::ObjectPtr}, {}, RTAttrs::None},
+
+    // void _d_delstruct(void** p, TypeInfo_Struct inf)
+    {RTFunc::_d_delstruct, "_d_delstruct", LINKc, RTType::Void,
+     {RTType::VoidPtrPtr, RTType::TypeInfoStruct}, {}, RTAttrs::None},
+
+    // array slice copy when assertions are on!
+    // void _d_array_slice_copy(void* dst, size_t dstlen, void* src,
+    //                          size_t srclen)
+    {RTFunc::_d_array_slice_copy, "_d_array_slice_copy", LINKc, RTType::Void,
+     {RTType::VoidPtr, RTType::SizeT, RTType::VoidPtr, RTType::SizeT}, {},
+     RTAttrs::NoCapture_1_3},
 
-  // the call to DtoType performs many actions such as rewriting the function
-  // type and storing it in dty
-  auto llfunctype = llvm::cast<llvm::FunctionType>(DtoType(dty));
-  assert(dty->ctype);
-  auto attrs =
-      dty->ctype->getIrFuncTy().getParamAttrs(gABI->passThisBeforeSret(dty));
-  attrs.merge(attribset);
+////////////////////////////////////////////////////////////////////////////////
 
-  for (auto fname : fnames) {
-    llvm::Function *fn = llvm::Function::Create(
-        llfunctype, llvm::GlobalValue::ExternalLinkage, fname, M);
+// int _aApplycd1(in char[] aa, dg_t dg)
+// int _aApplyRcd1(in char[] aa, dg_t dg)
+#define STR_APPLY(TY, a, b, n)                                                 \
+  {RTFunc::_aApply##a##n, "_aApply" #a #n, LINKc, RTType::SizeT,               \
+   {TY, RTType::Dg##n}, {}, RTAttrs::None},                                    \
+      {RTFunc::_aApply##b##n, "_aApply" #b #n, LINKc, RTType::SizeT,           \
+       {TY, RTType::Dg##n}, {}, RTAttrs::None},                                \
+      {RTFunc::_aApplyR##a##n, "_aApplyR" #a #n, LINKc, RTType::SizeT,         \
+       {TY, RTType::Dg##n}, {}, RTAttrs::None},                                \
+      {RTFunc::_aApplyR##b##n, "_aApplyR" #b #n, LINKc, RTType::SizeT,         \
+       {TY, RTType::Dg##n}, {}, RTAttrs::None},
+    STR_APPLY(RTType::String, cw, cd, 1)
+    STR_APPLY(RTType::WString, wc, wd, 1)
+    STR_APPLY(RTType::DString, dc, dw, 1)
 
-    fn->setAttributes(attrs);
+// int _aApplycd2(in char[] aa, dg2_t dg)
+// int _aApplyRcd2(in char[] aa, dg2_t dg)
+    STR_APPLY(RTType::String, cw, cd, 2)
+    STR_APPLY(RTType::WString, wc, wd, 2)
+    STR_APPLY(RTType::DString, dc, dw, 2)
+#undef STR_APPLY
+
+    ////////////////////////////////////////////////////////////////////////////
+
+    // fixes the length for dynamic array casts
+    // size_t _d_array_cast_len(size_t len, size_t elemsz, size_t newelemsz)
+    {RTFunc::_d_array_cast_len, "_d_array_cast_len", LINKc, RTType::SizeT,
+     {RTType::SizeT, RTType::SizeT, RTType::SizeT}, {}, RTAttrs::ReadNone},
+
+    // void[] _d_arrayassign_l(TypeInfo ti, void[] src, void[] dst,
+    //                         void* ptmp)
+    // void[] _d_arrayassign_r(TypeInfo ti, void[] src, void[] dst,
+    //                         void* ptmp)
+    {RTFunc::_d_arrayassign_l, "_d_arrayassign_l", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::VoidArray, RTType::VoidArray, RTType::VoidPtr},
+     {}, RTAttrs::None},
+    {RTFunc::_d_arrayassign_r, "_d_arrayassign_r", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::VoidArray, RTType::VoidArray, RTType::VoidPtr},
+     {}, RTAttrs::None},
+
+    // void[] _d_arrayctor(TypeInfo ti, void[] from, void[] to)
+    {RTFunc::_d_arrayctor, "_d_arrayctor", LINKc, RTType::VoidArray,
+     {RTType::TypeInfo, RTType::VoidArray, RTType::VoidArray}, {},
+     RTAttrs::None},
+
+    // void* _d_arraysetassign(void* p, void* value, int count, TypeInfo ti)
+    // void* _d_arraysetctor(void* p, void* value, int count, TypeInfo ti)
+    {RTFunc::_d_arraysetassign, "_d_arraysetassign", LINKc, RTType::VoidPtr,
+     {RTType::VoidPtr, RTType::VoidPtr, RTType::Int, RTType::TypeInfo}, {},
+     RTAttrs::NoAlias},
+    {RTFunc::_d_arraysetctor, "_d_arraysetctor", LINKc, RTType::VoidPtr,
+     {RTType::VoidPtr, RTType::VoidPtr, RTType::Int, RTType::TypeInfo}, {},
+     RTAttrs::NoAlias},
+
+    ////////////////////////////////////////////////////////////////////////////
+
+    // cast interface
+    // void* _d_interface_cast(void* p, ClassInfo c)
+    {RTFunc::_d_interface_cast, "_d_interface_cast", LINKc, RTType::VoidPtr,
+     {RTType::VoidPtr, RTType::ClassInfo}, {}, RTAttrs::ReadOnly_NoUnwind},
+
+    // dynamic cast
+    // void* _d_dynamic_cast(Object o, ClassInfo c)
+    {RTFunc::_d_dynamic_cast, "_d_dynamic_cast", LINKc, RTType::VoidPtr,
+     {RTType::Object, RTType::ClassInfo}, {}, RTAttrs::ReadOnly_NoUnwind},
+
+    ////////////////////////////////////////////////////////////////////////////
+
+    // char[] _adReverseChar(char[] a)
+    // char[] _adSortChar(char[] a)
+    {RTFunc::_adReverseChar, "_adReverseChar", LINKc, RTType::String,
+     {RTType::String}, {}, RTAttrs::None},
+    {RTFunc::_adSortChar, "_adSortChar", LINKc, RTType::String,
+     {RTType::String}, {}, RTAttrs::None},
+
+    // wchar[] _adReverseWchar(wchar[] a)
+    // wchar[] _adSortWchar(wchar[] a)
+    {RTFunc::_adReverseWchar, "_adReverseWchar", LINKc, RTType::WString,
+     {RTType::WString}, {}, RTAttrs::None},
+    {RTFunc::_adSortWchar, "_adSortWchar", LINKc, RTType::WString,
+     {RTType::WString}, {}, RTAttrs::None},
+
+    // void[] _adReverse(void[] a, size_t szelem)
+    {RTFunc::_adReverse, "_adReverse", LINKc, RTType::WString,
+     {RTType::VoidArray, RTType::SizeT}, {}, RTAttrs::NoUnwind},
+
+    // int _adEq2(void[] a1, void[] a2, TypeInfo ti)
+    // int _adCmp2(void[] a1, void[] a2, TypeInfo ti)
+    {RTFunc::_adEq2, "_adEq2", LINKc, RTType::Int,
+     {RTType::VoidArray, RTType::VoidArray, RTType::TypeInfo}, {},
+     RTAttrs::ReadOnly},
+    {RTFunc::_adCmp2, "_adCmp2", LINKc, RTType::Int,
+     {RTType::VoidArray, RTType::VoidArray, RTType::TypeInfo}, {},
+     RTAttrs::ReadOnly},
+
+    // int _adCmpChar(void[] a1, void[] a2)
+    {RTFunc::_adCmpChar, "_adCmpChar", LINKc, RTType::Int,
+     {RTType::VoidArray, RTType::VoidArray}, {}, RTAttrs::ReadOnly_NoUnwind},
+
+    // void[] _adSort(void[] a, TypeInfo ti)
+    {RTFunc::_adSort, "_adSort", LINKc, RTType::VoidArray,
+     {RTType::VoidArray, RTType::TypeInfo}, {}, RTAttrs::None},
+
+    ////////////////////////////////////////////////////////////////////////////
+
+    // size_t _aaLen(in AA aa)
+    {RTFunc::_aaLen, "_aaLen", LINKc, RTType::SizeT, {RTType::AA}, {STCin},
+     RTAttrs::ReadOnly_NoUnwind_1_NoCapture},
+
+    // void* _aaGetY(AA* aa, const TypeInfo aati, in size_t valuesize,
+    //               in void* pkey)
+    {RTFunc::_aaGetY, "_aaGetY", LINKc, RTType::VoidPtr,
+     {RTType::AAPtr, RTType::AATypeInfo, RTType::SizeT, RTType::VoidPtr},
+     {0, STCconst, STCin, STCin}, RTAttrs::NoCapture_1_4},
+
+    // inout(void)* _aaInX(inout AA aa, in TypeInfo keyti, in void* pkey)
+    // FIXME: "inout" storageclass is not applied to return type
+    {RTFunc::_aaInX, "_aaInX", LINKc, RTType::VoidPtr,
+     {RTType::AA, RTType::TypeInfo, RTType::VoidPtr},
+     {STCin | STCout, STCin, STCin}, RTAttrs::ReadOnly_1_3_NoCapture},
+
+    // bool _aaDelX(AA aa, in TypeInfo keyti, in void* pkey)
+    {RTFunc::_aaDelX, "_aaDelX", LINKc, RTType::Bool,
+     {RTType::AA, RTType::TypeInfo, RTType::VoidPtr}, {0, STCin, STCin},
+     RTAttrs::NoCapture_1_3},
+
+    // inout(void[]) _aaValues(inout AA aa, in size_t keysize,
+    //                         in size_t valuesize, const TypeInfo tiValueArray)
+    {RTFunc::_aaValues, "_aaValues", LINKc, RTType::VoidArray,
+     {RTType::AA, RTType::SizeT, RTType::SizeT, RTType::TypeInfo},
+     {STCin | STCout, STCin, STCin, STCconst},
+     RTAttrs::ReadOnly_1_3_NoCapture},
+
+    // void* _aaRehash(AA* paa, in TypeInfo keyti)
+    {RTFunc::_aaRehash, "_aaRehash", LINKc, RTType::VoidPtr,
+     {RTType::AAPtr, RTType::TypeInfo}, {0, STCin}, RTAttrs::None},
+
+    // inout(void[]) _aaKeys(inout AA aa, in size_t keysize,
+    //                       const TypeInfo tiKeyArray)
+    {RTFunc::_aaKeys, "_aaKeys", LINKc, RTType::VoidArray,
+     {RTType::AA, RTType::SizeT, RTType::TypeInfo},
+     {STCin | STCout, STCin, STCconst}, RTAttrs::NoAlias_1_NoCapture},
+
+    // int _aaApply(AA aa, in size_t keysize, dg_t dg)
+    {RTFunc::_aaApply, "_aaApply", LINKc, RTType::Int,
+     {RTType::AA, RTType::SizeT, RTType::Dg1}, {0, STCin, 0},
+     RTAttrs::NoCapture_1},
+
+    // int _aaApply2(AA aa, in size_t keysize, dg2_t dg)
+    {RTFunc::_aaApply2, "_aaApply2", LINKc, RTType::Int,
+     {RTType::AA, RTType::SizeT, RTType::Dg2}, {0, STCin, 0},
+     RTAttrs::NoCapture_1},
+
+    // int _aaEqual(in TypeInfo tiRaw, in AA e1, in AA e2)
+    {RTFunc::_aaEqual, "_aaEqual", LINKc, RTType::Int,
+     {RTType::TypeInfo, RTType::AA, RTType::AA}, {STCin, STCin, STCin},
+     RTAttrs::NoCapture_1_2},
+
+    // AA _d_assocarrayliteralTX(const TypeInfo_AssociativeArray ti,
+    //                           void[] keys, void[] values)
+    {RTFunc::_d_assocarrayliteralTX, "_d_assocarrayliteralTX", LINKc,
+     RTType::AA, {RTType::AATypeInfo, RTType::VoidArray, RTType::VoidArray},
+     {STCconst, 0, 0}, RTAttrs::None},
+
+    ////////////////////////////////////////////////////////////////////////////
+
+    // void _moduleCtor()
+    // void _moduleDtor()
+    {RTFunc::_moduleCtor, "_moduleCtor", LINKc, RTType::Void, {}, {},
+     RTAttrs::None},
+    {RTFunc::_moduleDtor, "_moduleDtor", LINKc, RTType::Void, {}, {},
+     RTAttrs::None},
+
+    // void _d_throw_exception(Object e)
+    {RTFunc::_d_throw_exception, "_d_throw_exception", LINKc, RTType::Void,
+     {RTType::Object}, {}, RTAttrs::None},
+
+    // int _d_switch_string(char[][] table, char[] ca)
+    {RTFunc::_d_switch_string, "_d_switch_string", LINKc, RTType::Int,
+     {RTType::StringArray, RTType::String}, {}, RTAttrs::ReadOnly},
+
+    // int _d_switch_ustring(wchar[][] table, wchar[] ca)
+    {RTFunc::_d_switch_ustring, "_d_switch_ustring", LINKc, RTType::Int,
+     {RTType::WStringArray, RTType::WString}, {}, RTAttrs::ReadOnly},
+
+    // int _d_switch_dstring(dchar[][] table, dchar[] ca)
+    {RTFunc::_d_switch_dstring, "_d_switch_dstring", LINKc, RTType::Int,
+     {RTType::DStringArray, RTType::DString}, {}, RTAttrs::ReadOnly},
+
+    ////////////////////////////////////////////////////////////////////////////
+
+    // int _d_eh_personality(int ver, int actions, ulong eh_class,
+    //                       ptr eh_info, ptr context)
+    // (see lookupRuntimeFunction() for the ARM and MSVC variants)
+    {RTFunc::_d_eh_personality, "_d_eh_personality", LINKc, RTType::Int,
+     {RTType::Int, RTType::Int, RTType::ULong, RTType::VoidPtr,
+      RTType::VoidPtr},
+     {}, RTAttrs::None},
+
+    // int __CxxFrameHandler3(ptr ExceptionRecord, ptr EstablisherFrame,
+    //                        ptr ContextRecord, ptr DispatcherContext)
+    {RTFunc::__CxxFrameHandler3, "__CxxFrameHandler3", LINKc, RTType::Int,
+     {RTType::VoidPtr, RTType::VoidPtr, RTType::VoidPtr, RTType::VoidPtr},
+     {}, RTAttrs::None},
+
+    // bool _d_enter_cleanup(ptr frame)
+    {RTFunc::_d_enter_cleanup, "_d_enter_cleanup", LINKc, RTType::Bool,
+     {RTType::VoidPtr}, {}, RTAttrs::NoUnwind},
+
+    // void _d_leave_cleanup(ptr frame)
+    {RTFunc::_d_leave_cleanup, "_d_leave_cleanup", LINKc, RTType::Void,
+     {RTType::VoidPtr}, {}, RTAttrs::NoUnwind},
 
-    // On x86_64, always set 'uwtable' for System V ABI compatibility.
-    // FIXME: Move to better place (abi-x86-64.cpp?)
-    // NOTE: There are several occurances if this line.
-    if (global.params.targetTriple->getArch() == llvm::Triple::x86_64) {
-      fn->addFnAttr(LLAttribute::UWTable);
-    }
+    // Object _d_eh_enter_catch(ptr)
+    // (see lookupRuntimeFunction() for the MSVC variant)
+    {RTFunc::_d_eh_enter_catch, "_d_eh_enter_catch", LINKc, RTType::Object,
+     {RTType::VoidPtr}, {}, RTAttrs::NoUnwind},
 
-    fn->setCallingConv(gABI->callingConv(fn->getFunctionType(), linkage));
-  }
-}
+    // void _d_eh_resume_unwind(ptr)
+    // (cold, so that the paths only taken when unwinding are laid out after
+    // the normal code)
+    {RTFunc::_d_eh_resume_unwind, "_d_eh_resume_unwind", LINKc, RTType::Void,
+     {RTType::VoidPtr}, {}, RTAttrs::Cold_NoReturn},
 
-static void buildRuntimeModule() {
-  Logger::println("building runtime module");
-  M = new llvm::Module("ldc internal runtime", gIR->context());
-
-  Type *voidTy = Type::tvoid;
-  Type *boolTy = Type::tbool;
-  Type *ubyteTy = Type::tuns8;
-  Type *intTy = Type::tint32;
-  Type *uintTy = Type::tuns32;
-  Type *ulongTy = Type::tuns64;
-  Type *sizeTy = Type::tsize_t;
-  Type *dcharTy = Type::tdchar;
-
-  Type *voidPtrTy = Type::tvoidptr;
-  Type *voidArrayTy = Type::tvoid->arrayOf();
-  Type *voidArrayPtrTy = voidArrayTy->pointerTo();
-  Type *stringTy = Type::tchar->arrayOf();
-  Type *wstringTy = Type::twchar->arrayOf();
-  Type *dstringTy = Type::tdchar->arrayOf();
-
-  // Ensure that the declarations exist before creating llvm types for them.
-  ensureDecl(ClassDeclaration::object, "Object");
-  ensureDecl(Type::typeinfoclass, "TypeInfo_Class");
-  ensureDecl(Type::dtypeinfo, "DTypeInfo");
-  ensureDecl(Type::typeinfoassociativearray, "TypeInfo_AssociativeArray");
-  ensureDecl(Module::moduleinfo, "ModuleInfo");
-
-  Type *objectTy = ClassDeclaration::object->type;
-  Type *classInfoTy = Type::typeinfoclass->type;
-  Type *typeInfoTy = Type::dtypeinfo->type;
-  Type *aaTypeInfoTy = Type::typeinfoassociativearray->type;
-  Type *moduleInfoPtrTy = Module::moduleinfo->type->pointerTo();
-  // The AA type is a struct that only contains a ptr
-  Type *aaTy = voidPtrTy;
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // Construct some attribute lists used below (possibly multiple times)
-  AttrSet NoAttrs, Attr_NoAlias(NoAttrs, llvm::AttributeSet::ReturnIndex,
-                                llvm::Attribute::NoAlias),
-      Attr_NoUnwind(NoAttrs, llvm::AttributeSet::FunctionIndex,
-                    llvm::Attribute::NoUnwind),
-      Attr_ReadOnly(NoAttrs, llvm::AttributeSet::FunctionIndex,
-                    llvm::Attribute::ReadOnly),
-      Attr_Cold(NoAttrs, llvm::AttributeSet::FunctionIndex,
-                llvm::Attribute::Cold),
-      Attr_Cold_NoReturn(Attr_Cold, llvm::AttributeSet::FunctionIndex,
-                         llvm::Attribute::NoReturn),
-      Attr_ReadOnly_NoUnwind(Attr_ReadOnly, llvm::AttributeSet::FunctionIndex,
-                             llvm::Attribute::NoUnwind),
-      Attr_ReadOnly_1_NoCapture(Attr_ReadOnly, 1, llvm::Attribute::NoCapture),
-      Attr_ReadOnly_1_3_NoCapture(Attr_ReadOnly_1_NoCapture, 3,
-                                  llvm::Attribute::NoCapture),
-      Attr_ReadOnly_NoUnwind_1_NoCapture(Attr_ReadOnly_1_NoCapture, ~0U,
-                                         llvm::Attribute::NoUnwind),
-      Attr_ReadNone(NoAttrs, ~0U, llvm::Attribute::ReadNone),
-      Attr_1_NoCapture(NoAttrs, 1, llvm::Attribute::NoCapture),
-      Attr_NoAlias_1_NoCapture(Attr_1_NoCapture, 0, llvm::Attribute::NoAlias),
-      Attr_1_2_NoCapture(Attr_1_NoCapture, 2, llvm::Attribute::NoCapture),
-      Attr_1_3_NoCapture(Attr_1_NoCapture, 3, llvm::Attribute::NoCapture),
-      Attr_1_4_NoCapture(Attr_1_NoCapture, 4, llvm::Attribute::NoCapture);
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // void _d_assert(string file, uint line)
-  // void _d_arraybounds(string file, uint line)
-  createFwdDecl(LINKc, Type::tvoid, {"_d_assert", "_d_arraybounds"},
-                {stringTy, uintTy}, {}, Attr_Cold_NoReturn);
-
-  // void _d_assert_msg(string msg, string file, uint line)
-  createFwdDecl(LINKc, voidTy, {"_d_assert_msg"}, {stringTy, stringTy, uintTy},
-                {}, Attr_Cold_NoReturn);
-
-  // void _d_assertm(immutable(ModuleInfo)* m, uint line)
-  // void _d_array_bounds(immutable(ModuleInfo)* m, uint line)
-  // void _d_switch_error(immutable(ModuleInfo)* m, uint line)
-  createFwdDecl(
-      LINKc, voidTy, {"_d_assertm", "_d_array_bounds", "_d_switch_error"},
-      {moduleInfoPtrTy, uintTy}, {STCimmutable, 0}, Attr_Cold_NoReturn);
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // void* _d_allocmemory(size_t sz)
-  createFwdDecl(LINKc, voidPtrTy, {"_d_allocmemory"}, {sizeTy}, {},
-                Attr_NoAlias);
-
-  // void* _d_allocmemoryT(TypeInfo ti)
-  createFwdDecl(LINKc, voidPtrTy, {"_d_allocmemoryT"}, {typeInfoTy}, {},
-                Attr_NoAlias);
-
-  // void[] _d_newarrayT (const TypeInfo ti, size_t length)
-  // void[] _d_newarrayiT(const TypeInfo ti, size_t length)
-  // void[] _d_newarrayU (const TypeInfo ti, size_t length)
-  createFwdDecl(LINKc, voidArrayTy,
-                {"_d_newarrayT", "_d_newarrayiT", "_d_newarrayU"},
-                {typeInfoTy, sizeTy}, {STCconst, 0});
-
-  // void[] _d_newarraymTX (const TypeInfo ti, size_t[] dims)
-  // void[] _d_newarraymiTX(const TypeInfo ti, size_t[] dims)
-  createFwdDecl(LINKc, voidArrayTy, {"_d_newarraymTX", "_d_newarraymiTX"},
-                {typeInfoTy, sizeTy->arrayOf()}, {STCconst, 0});
-
-  // void[] _d_arraysetlengthT (const TypeInfo ti, size_t newlength, void[]* p)
-  // void[] _d_arraysetlengthiT(const TypeInfo ti, size_t newlength, void[]* p)
-  createFwdDecl(LINKc, voidArrayTy,
-                {"_d_arraysetlengthT", "_d_arraysetlengthiT"},
-                {typeInfoTy, sizeTy, voidArrayPtrTy}, {STCconst, 0, 0});
-
-  // byte[] _d_arrayappendcTX(const TypeInfo ti, ref byte[] px, size_t n)
-  createFwdDecl(LINKc, voidArrayTy, {"_d_arrayappendcTX"},
-                {typeInfoTy, voidArrayTy, sizeTy}, {STCconst, STCref, 0});
-
-  // void[] _d_arrayappendT(const TypeInfo ti, ref byte[] x, byte[] y)
-  createFwdDecl(LINKc, voidArrayTy, {"_d_arrayappendT"},
-                {typeInfoTy, voidArrayTy, voidArrayTy}, {STCconst, STCref, 0});
-
-  // void[] _d_arrayappendcd(ref byte[] x, dchar c)
-  // void[] _d_arrayappendwd(ref byte[] x, dchar c)
-  createFwdDecl(LINKc, voidArrayTy, {"_d_arrayappendcd", "_d_arrayappendwd"},
-                {voidArrayTy, dcharTy}, {STCref, 0});
-
-  // byte[] _d_arraycatT(const TypeInfo ti, byte[] x, byte[] y)
-  createFwdDecl(LINKc, voidArrayTy, {"_d_arraycatT"},
-                {typeInfoTy, voidArrayTy, voidArrayTy}, {STCconst, 0, 0});
-
-  // void[] _d_arraycatnTX(const TypeInfo ti, byte[][] arrs)
-  createFwdDecl(LINKc, voidArrayTy, {"_d_arraycatnTX"},
-                {typeInfoTy, voidArrayTy->arrayOf()}, {STCconst, 0});
-
-  // Object _d_newclass(const ClassInfo ci)
-  createFwdDecl(LINKc, objectTy, {"_d_newclass"}, {classInfoTy}, {STCconst},
-                Attr_NoAlias);
-
-  // void* _d_newitemT (TypeInfo ti)
-  // void* _d_newitemiT(TypeInfo ti)
-  createFwdDecl(LINKc, voidPtrTy, {"_d_newitemT", "_d_newitemiT"}, {typeInfoTy},
-                {0}, Attr_NoAlias);
-
-  // void _d_delarray_t(void[]* p, const TypeInfo_Struct ti)
-  createFwdDecl(LINKc, voidTy, {"_d_delarray_t"},
-                {voidArrayPtrTy, Type::typeinfostruct->type}, {0, STCconst});
-
-  // void _d_delmemory(void** p)
-  // void _d_delinterface(void** p)
-  createFwdDecl(LINKc, voidTy, {"_d_delmemory", "_d_delinterface"},
-                {voidPtrTy->pointerTo()});
-
-  // void _d_callfinalizer(void* p)
-  createFwdDecl(LINKc, voidTy, {"_d_callfinalizer"}, {voidPtrTy});
-
-  // D2: void _d_delclass(Object* p)
-  createFwdDecl(LINKc, voidTy, {"_d_delclass"}, {objectTy->pointerTo()});
-
-  // void _d_delstruct(void** p, TypeInfo_Struct inf)
-  createFwdDecl(LINKc, voidTy, {"_d_delstruct"},
-                {voidPtrTy->pointerTo(), Type::typeinfostruct->type});
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // array slice copy when assertions are on!
-  // void _d_array_slice_copy(void* dst, size_t dstlen, void* src, size_t
-  // srclen)
-  createFwdDecl(LINKc, voidTy, {"_d_array_slice_copy"},
-                {voidPtrTy, sizeTy, voidPtrTy, sizeTy}, {}, Attr_1_3_NoCapture);
+    ////////////////////////////////////////////////////////////////////////////
 
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+    // void invariant._d_invariant(Object o)
+    {RTFunc::_d_invariant, "_D9invariant12_d_invariantFC6ObjectZv", LINKd,
+     RTType::Void, {RTType::Object}, {}, RTAttrs::None},
 
-// int _aApplycd1(in char[] aa, dg_t dg)
-// int _aApplyRcd1(in char[] aa, dg_t dg)
-#define STR_APPLY1(TY, a, b)                                                   \
-  {                                                                            \
-    const std::string prefix = "_aApply";                                      \
-    std::string fname1 = prefix + (a) + '1', fname2 = prefix + (b) + '1',      \
-                fname3 = prefix + 'R' + (a) + '1',                             \
-                fname4 = prefix + 'R' + (b) + '1';                             \
-    createFwdDecl(LINKc, sizeTy, {fname1, fname2, fname3, fname4},             \
-                  {TY, rt_dg1()});                                             \
-  }
-  STR_APPLY1(stringTy, "cw", "cd")
-  STR_APPLY1(wstringTy, "wc", "wd")
-  STR_APPLY1(dstringTy, "dc", "dw")
-#undef STR_APPLY1
+    // void _d_dso_registry(CompilerDSOData* data)
+    // (signature built in buildSignature() as it has no D equivalent)
+    {RTFunc::_d_dso_registry, "_d_dso_registry", LINKc, RTType::Void, {}, {},
+     RTAttrs::None},
 
-// int _aApplycd2(in char[] aa, dg2_t dg)
-// int _aApplyRcd2(in char[] aa, dg2_t dg)
-#define STR_APPLY2(TY, a, b)                                                   \
-  {                                                                            \
-    const std::string prefix = "_aApply";                                      \
-    std::string fname1 = prefix + (a) + '2', fname2 = prefix + (b) + '2',      \
-                fname3 = prefix + 'R' + (a) + '2',                             \
-                fname4 = prefix + 'R' + (b) + '2';                             \
-    createFwdDecl(LINKc, sizeTy, {fname1, fname2, fname3, fname4},             \
-                  {TY, rt_dg2()});                                             \
-  }
-  STR_APPLY2(stringTy, "cw", "cd")
-  STR_APPLY2(wstringTy, "wc", "wd")
-  STR_APPLY2(dstringTy, "dc", "dw")
-#undef STR_APPLY2
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // fixes the length for dynamic array casts
-  // size_t _d_array_cast_len(size_t len, size_t elemsz, size_t newelemsz)
-  createFwdDecl(LINKc, sizeTy, {"_d_array_cast_len"}, {sizeTy, sizeTy, sizeTy},
-                {}, Attr_ReadNone);
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // void[] _d_arrayassign_l(TypeInfo ti, void[] src, void[] dst, void* ptmp)
-  // void[] _d_arrayassign_r(TypeInfo ti, void[] src, void[] dst, void* ptmp)
-  createFwdDecl(LINKc, voidArrayTy, {"_d_arrayassign_l", "_d_arrayassign_r"},
-                {typeInfoTy, voidArrayTy, voidArrayTy, voidPtrTy});
-
-  // void[] _d_arrayctor(TypeInfo ti, void[] from, void[] to)
-  createFwdDecl(LINKc, voidArrayTy, {"_d_arrayctor"},
-                {typeInfoTy, voidArrayTy, voidArrayTy});
-
-  // void* _d_arraysetassign(void* p, void* value, int count, TypeInfo ti)
-  // void* _d_arraysetctor(void* p, void* value, int count, TypeInfo ti)
-  createFwdDecl(LINKc, voidPtrTy, {"_d_arraysetassign", "_d_arraysetctor"},
-                {voidPtrTy, voidPtrTy, intTy, typeInfoTy}, {}, Attr_NoAlias);
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // cast interface
-  // void* _d_interface_cast(void* p, ClassInfo c)
-  createFwdDecl(LINKc, voidPtrTy, {"_d_interface_cast"},
-                {voidPtrTy, classInfoTy}, {}, Attr_ReadOnly_NoUnwind);
-
-  // dynamic cast
-  // void* _d_dynamic_cast(Object o, ClassInfo c)
-  createFwdDecl(LINKc, voidPtrTy, {"_d_dynamic_cast"}, {objectTy, classInfoTy},
-                {}, Attr_ReadOnly_NoUnwind);
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // char[] _adReverseChar(char[] a)
-  // char[] _adSortChar(char[] a)
-  createFwdDecl(LINKc, stringTy, {"_adReverseChar", "_adSortChar"}, {stringTy});
-
-  // wchar[] _adReverseWchar(wchar[] a)
-  // wchar[] _adSortWchar(wchar[] a)
-  createFwdDecl(LINKc, wstringTy, {"_adReverseWchar", "_adSortWchar"},
-                {wstringTy});
-
-  // void[] _adReverse(void[] a, size_t szelem)
-  createFwdDecl(LINKc, wstringTy, {"_adReverse"}, {voidArrayTy, sizeTy}, {},
-                Attr_NoUnwind);
-
-  // int _adEq2(void[] a1, void[] a2, TypeInfo ti)
-  // int _adCmp2(void[] a1, void[] a2, TypeInfo ti)
-  createFwdDecl(LINKc, intTy, {"_adEq2", "_adCmp2"},
-                {voidArrayTy, voidArrayTy, typeInfoTy}, {}, Attr_ReadOnly);
-
-  // int _adCmpChar(void[] a1, void[] a2)
-  createFwdDecl(LINKc, intTy, {"_adCmpChar"}, {voidArrayTy, voidArrayTy}, {},
-                Attr_ReadOnly_NoUnwind);
-
-  // void[] _adSort(void[] a, TypeInfo ti)
-  createFwdDecl(LINKc, voidArrayTy, {"_adSort"}, {voidArrayTy, typeInfoTy});
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // size_t _aaLen(in AA aa)
-  createFwdDecl(LINKc, sizeTy, {"_aaLen"}, {aaTy}, {STCin},
-                Attr_ReadOnly_NoUnwind_1_NoCapture);
-
-  // void* _aaGetY(AA* aa, const TypeInfo aati, in size_t valuesize,
-  //               in void* pkey)
-  createFwdDecl(LINKc, voidPtrTy, {"_aaGetY"},
-                {aaTy->pointerTo(), aaTypeInfoTy, sizeTy, voidPtrTy},
-                {0, STCconst, STCin, STCin}, Attr_1_4_NoCapture);
-
-  // inout(void)* _aaInX(inout AA aa, in TypeInfo keyti, in void* pkey)
-  // FIXME: "inout" storageclass is not applied to return type
-  createFwdDecl(LINKc, voidPtrTy, {"_aaInX"}, {aaTy, typeInfoTy, voidPtrTy},
-                {STCin | STCout, STCin, STCin}, Attr_ReadOnly_1_3_NoCapture);
-
-  // bool _aaDelX(AA aa, in TypeInfo keyti, in void* pkey)
-  createFwdDecl(LINKc, boolTy, {"_aaDelX"}, {aaTy, typeInfoTy, voidPtrTy},
-                {0, STCin, STCin}, Attr_1_3_NoCapture);
-
-  // inout(void[]) _aaValues(inout AA aa, in size_t keysize,
-  //                         in size_t valuesize, const TypeInfo tiValueArray)
-  createFwdDecl(
-      LINKc, voidArrayTy, {"_aaValues"}, {aaTy, sizeTy, sizeTy, typeInfoTy},
-      {STCin | STCout, STCin, STCin, STCconst}, Attr_ReadOnly_1_3_NoCapture);
-
-  // void* _aaRehash(AA* paa, in TypeInfo keyti)
-  createFwdDecl(LINKc, voidPtrTy, {"_aaRehash"},
-                {aaTy->pointerTo(), typeInfoTy}, {0, STCin});
-
-  // inout(void[]) _aaKeys(inout AA aa, in size_t keysize,
-  //                       const TypeInfo tiKeyArray)
-  createFwdDecl(LINKc, voidArrayTy, {"_aaKeys"}, {aaTy, sizeTy, typeInfoTy},
-                {STCin | STCout, STCin, STCconst}, Attr_NoAlias_1_NoCapture);
-
-  // int _aaApply(AA aa, in size_t keysize, dg_t dg)
-  createFwdDecl(LINKc, intTy, {"_aaApply"}, {aaTy, sizeTy, rt_dg1()},
-                {0, STCin, 0}, Attr_1_NoCapture);
-
-  // int _aaApply2(AA aa, in size_t keysize, dg2_t dg)
-  createFwdDecl(LINKc, intTy, {"_aaApply2"}, {aaTy, sizeTy, rt_dg2()},
-                {0, STCin, 0}, Attr_1_NoCapture);
-
-  // int _aaEqual(in TypeInfo tiRaw, in AA e1, in AA e2)
-  createFwdDecl(LINKc, intTy, {"_aaEqual"}, {typeInfoTy, aaTy, aaTy},
-                {STCin, STCin, STCin}, Attr_1_2_NoCapture);
-
-  // AA _d_assocarrayliteralTX(const TypeInfo_AssociativeArray ti,
-  //                           void[] keys, void[] values)
-  createFwdDecl(LINKc, aaTy, {"_d_assocarrayliteralTX"},
-                {aaTypeInfoTy, voidArrayTy, voidArrayTy}, {STCconst, 0, 0});
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // void _moduleCtor()
-  // void _moduleDtor()
-  createFwdDecl(LINKc, voidTy, {"_moduleCtor", "_moduleDtor"}, {});
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // void _d_throw_exception(Object e)
-  createFwdDecl(LINKc, voidTy, {"_d_throw_exception"}, {objectTy});
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // int _d_switch_string(char[][] table, char[] ca)
-  createFwdDecl(LINKc, intTy, {"_d_switch_string"},
-                {stringTy->arrayOf(), stringTy}, {}, Attr_ReadOnly);
-
-  // int _d_switch_ustring(wchar[][] table, wchar[] ca)
-  createFwdDecl(LINKc, intTy, {"_d_switch_ustring"},
-                {wstringTy->arrayOf(), wstringTy}, {}, Attr_ReadOnly);
-
-  // int _d_switch_dstring(dchar[][] table, dchar[] ca)
-  createFwdDecl(LINKc, intTy, {"_d_switch_dstring"},
-                {dstringTy->arrayOf(), dstringTy}, {}, Attr_ReadOnly);
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // int _d_eh_personality(...)
-  {
+    // extern (C) void _d_cover_register2(string filename, size_t[] valid,
+    //                                    uint[] data, ubyte minPercent)
+    {RTFunc::_d_cover_register2, "_d_cover_register2", LINKc, RTType::Void,
+     {RTType::String, RTType::SizeTArray, RTType::UIntArray, RTType::UByte},
+     {}, RTAttrs::None},
+
+    ////////////////////////////////////////////////////////////////////////////
+
+    // The types of these functions don't really matter because they are
+    // always bitcast to correct signature before calling.
+
+    // id objc_msgSend(id self, SEL op, ...)
+    // Function called early and/or often, so lazy binding isn't worthwhile.
+    {RTFunc::objc_msgSend, "objc_msgSend", LINKc, RTType::VoidPtr,
+     {RTType::VoidPtr, RTType::VoidPtr}, {}, RTAttrs::NonLazyBind},
+
+    // creal objc_msgSend_fp2ret(id self, SEL op, ...)
+    {RTFunc::objc_msgSend_fp2ret, "objc_msgSend_fp2ret", LINKc,
+     RTType::Complex80, {RTType::VoidPtr, RTType::VoidPtr}, {},
+     RTAttrs::None},
+
+    // real objc_msgSend_fpret(id self, SEL op, ...)
+    {RTFunc::objc_msgSend_fpret, "objc_msgSend_fpret", LINKc, RTType::Real80,
+     {RTType::VoidPtr, RTType::VoidPtr}, {}, RTAttrs::None},
+
+    // used when return value is aggregate via a hidden sret arg
+    // void objc_msgSend_stret(T *sret_arg, id self, SEL op, ...)
+    {RTFunc::objc_msgSend_stret, "objc_msgSend_stret", LINKc, RTType::Void,
+     {RTType::VoidPtr, RTType::VoidPtr}, {}, RTAttrs::None},
+};
+
+static_assert(sizeof(runtimeFunctions) / sizeof(runtimeFunctions[0]) ==
+                  RTFunc::NumFunctions,
+              "Runtime function table out of sync with RTFunc::Type");
+
+// Target-dependent signatures.
+
+// int _d_eh_personality(int state, ptr ucb, ptr context)
+const RTFunctionDesc armPersonality = {
+    RTFunc::_d_eh_personality, "_d_eh_personality", LINKc, RTType::Int,
+    {RTType::Int, RTType::VoidPtr, RTType::VoidPtr}, {}, RTAttrs::None};
+
+// int _d_eh_personality(ptr ExceptionRecord, ptr EstablisherFrame,
+//                       ptr ContextRecord, ptr DispatcherContext)
+const RTFunctionDesc msvcPersonality = {
+    RTFunc::_d_eh_personality, "_d_eh_personality", LINKc, RTType::Int,
+    {RTType::VoidPtr, RTType::VoidPtr, RTType::VoidPtr, RTType::VoidPtr}, {},
+    RTAttrs::None};
+
+// Object _d_eh_enter_catch(ptr exception, ClassInfo catchType)
+const RTFunctionDesc msvcEnterCatch = {
+    RTFunc::_d_eh_enter_catch, "_d_eh_enter_catch", LINKc, RTType::Object,
+    {RTType::VoidPtr, RTType::ClassInfo}, {}, RTAttrs::None};
+
+const RTFunctionDesc &lookupRuntimeFunction(RTFunc::Type id) {
+  assert(id < RTFunc::NumFunctions);
+  switch (id) {
+  case RTFunc::_d_eh_personality:
     if (global.params.targetTriple->isWindowsMSVCEnvironment()) {
-      const char *fname =
-          useMSVCEH() ? "__CxxFrameHandler3" : "_d_eh_personality";
-      // (ptr ExceptionRecord, ptr EstablisherFrame, ptr ContextRecord,
-      //  ptr DispatcherContext)
-      createFwdDecl(LINKc, intTy, {fname},
-                    {voidPtrTy, voidPtrTy, voidPtrTy, voidPtrTy});
-    } else if (global.params.targetTriple->getArch() == llvm::Triple::arm) {
-      // (int state, ptr ucb, ptr context)
-      createFwdDecl(LINKc, intTy, {"_d_eh_personality"},
-                    {intTy, voidPtrTy, voidPtrTy});
-    } else {
-      // (int ver, int actions, ulong eh_class, ptr eh_info, ptr context)
-      createFwdDecl(LINKc, intTy, {"_d_eh_personality"},
-                    {intTy, intTy, ulongTy, voidPtrTy, voidPtrTy});
+      return msvcPersonality;
+    }
+    if (global.params.targetTriple->getArch() == llvm::Triple::arm) {
+      return armPersonality;
     }
+    break;
+  case RTFunc::_d_eh_enter_catch:
+    if (useMSVCEH()) {
+      return msvcEnterCatch;
+    }
+    break;
+  default:
+    break;
   }
+  return runtimeFunctions[id];
+}
 
-  if (useMSVCEH()) {
-    // _d_enter_cleanup(ptr frame)
-    createFwdDecl(LINKc, boolTy, {"_d_enter_cleanup"}, {voidPtrTy});
-
-    // _d_leave_cleanup(ptr frame)
-    createFwdDecl(LINKc, voidTy, {"_d_leave_cleanup"}, {voidPtrTy});
-
-    // Object _d_eh_enter_catch(ptr exception, ClassInfo catchType)
-    createFwdDecl(LINKc, objectTy, {"_d_eh_enter_catch"},
-                  {voidPtrTy, classInfoTy}, {});
-  } else {
+////////////////////////////////////////////////////////////////////////////////
 
-    // void _d_eh_resume_unwind(ptr)
-    createFwdDecl(LINKc, voidTy, {"_d_eh_resume_unwind"}, {voidPtrTy});
+Type *getRTType(RTType t) {
+  switch (t) {
+  case RTType::None:
+    break;
+  case RTType::Void:
+    return Type::tvoid;
+  case RTType::Bool:
+    return Type::tbool;
+  case RTType::UByte:
+    return Type::tuns8;
+  case RTType::Int:
+    return Type::tint32;
+  case RTType::UInt:
+    return Type::tuns32;
+  case RTType::ULong:
+    return Type::tuns64;
+  case RTType::SizeT:
+    return Type::tsize_t;
+  case RTType::DChar:
+    return Type::tdchar;
+  case RTType::Real80:
+    return Type::tfloat80;
+  case RTType::Complex80:
+    return Type::tcomplex80;
+  case RTType::VoidPtr:
+  // The AA type is a struct that only contains a ptr
+  case RTType::AA:
+    return Type::tvoidptr;
+  case RTType::VoidPtrPtr:
+  case RTType::AAPtr:
+    return Type::tvoidptr->pointerTo();
+  case RTType::VoidArray:
+    return Type::tvoid->arrayOf();
+  case RTType::VoidArrayPtr:
+    return Type::tvoid->arrayOf()->pointerTo();
+  case RTType::VoidArrayArray:
+    return Type::tvoid->arrayOf()->arrayOf();
+  case RTType::String:
+    return Type::tchar->arrayOf();
+  case RTType::WString:
+    return Type::twchar->arrayOf();
+  case RTType::DString:
+    return Type::tdchar->arrayOf();
+  case RTType::StringArray:
+    return Type::tchar->arrayOf()->arrayOf();
+  case RTType::WStringArray:
+    return Type::twchar->arrayOf()->arrayOf();
+  case RTType::DStringArray:
+    return Type::tdchar->arrayOf()->arrayOf();
+  case RTType::SizeTArray:
+    return Type::tsize_t->arrayOf();
+  case RTType::UIntArray:
+    return Type::tuns32->arrayOf();
+  case RTType::Object:
+    ensureDecl(ClassDeclaration::object, "Object");
+    return ClassDeclaration::object->type;
+  case RTType::ObjectPtr:
+    ensureDecl(ClassDeclaration::object, "Object");
+    return ClassDeclaration::object->type->pointerTo();
+  case RTType::ClassInfo:
+    ensureDecl(Type::typeinfoclass, "TypeInfo_Class");
+    return Type::typeinfoclass->type;
+  case RTType::TypeInfo:
+    ensureDecl(Type::dtypeinfo, "DTypeInfo");
+    return Type::dtypeinfo->type;
+  case RTType::TypeInfoStruct:
+    ensureDecl(Type::typeinfostruct, "TypeInfo_Struct");
+    return Type::typeinfostruct->type;
+  case RTType::AATypeInfo:
+    ensureDecl(Type::typeinfoassociativearray, "TypeInfo_AssociativeArray");
+    return Type::typeinfoassociativearray->type;
+  case RTType::ModuleInfoPtr:
+    ensureDecl(Module::moduleinfo, "ModuleInfo");
+    return Module::moduleinfo->type->pointerTo();
+  case RTType::Dg1:
+    return rt_dg1();
+  case RTType::Dg2:
+    return rt_dg2();
+  }
+  llvm_unreachable("Unknown runtime signature type.");
+}
 
-    // Object _d_eh_enter_catch(ptr)
-    createFwdDecl(LINKc, objectTy, {"_d_eh_enter_catch"}, {voidPtrTy}, {},
-                  Attr_NoUnwind);
+AttrSet getRTAttrs(RTAttrs attrs) {
+  const unsigned FnIndex = llvm::AttributeSet::FunctionIndex;
+  const unsigned RetIndex = llvm::AttributeSet::ReturnIndex;
+  AttrSet NoAttrs;
+  switch (attrs) {
+  case RTAttrs::None:
+    return NoAttrs;
+  case RTAttrs::NoAlias:
+    return AttrSet(NoAttrs, RetIndex, llvm::Attribute::NoAlias);
+  case RTAttrs::NoUnwind:
+    return AttrSet(NoAttrs, FnIndex, llvm::Attribute::NoUnwind);
+  case RTAttrs::ReadOnly:
+    return AttrSet(NoAttrs, FnIndex, llvm::Attribute::ReadOnly);
+  case RTAttrs::ReadNone:
+    return AttrSet(NoAttrs, FnIndex, llvm::Attribute::ReadNone);
+  case RTAttrs::NonLazyBind:
+    return AttrSet(NoAttrs, FnIndex, llvm::Attribute::NonLazyBind);
+  case RTAttrs::Cold_NoReturn:
+    return AttrSet(AttrSet(NoAttrs, FnIndex, llvm::Attribute::Cold), FnIndex,
+                   llvm::Attribute::NoReturn);
+  case RTAttrs::ReadOnly_NoUnwind:
+    return AttrSet(getRTAttrs(RTAttrs::ReadOnly), FnIndex,
+                   llvm::Attribute::NoUnwind);
+  case RTAttrs::ReadOnly_1_3_NoCapture:
+    return AttrSet(AttrSet(getRTAttrs(RTAttrs::ReadOnly), 1,
+                           llvm::Attribute::NoCapture),
+                   3, llvm::Attribute::NoCapture);
+  case RTAttrs::ReadOnly_NoUnwind_1_NoCapture:
+    return AttrSet(getRTAttrs(RTAttrs::ReadOnly_NoUnwind), 1,
+                   llvm::Attribute::NoCapture);
+  case RTAttrs::NoCapture_1:
+    return AttrSet(NoAttrs, 1, llvm::Attribute::NoCapture);
+  case RTAttrs::NoAlias_1_NoCapture:
+    return AttrSet(getRTAttrs(RTAttrs::NoCapture_1), RetIndex,
+                   llvm::Attribute::NoAlias);
+  case RTAttrs::NoCapture_1_2:
+    return AttrSet(getRTAttrs(RTAttrs::NoCapture_1), 2,
+                   llvm::Attribute::NoCapture);
+  case RTAttrs::NoCapture_1_3:
+    return AttrSet(getRTAttrs(RTAttrs::NoCapture_1), 3,
+                   llvm::Attribute::NoCapture);
+  case RTAttrs::NoCapture_1_4:
+    return AttrSet(getRTAttrs(RTAttrs::NoCapture_1), 4,
+                   llvm::Attribute::NoCapture);
   }
+  llvm_unreachable("Unknown runtime attribute list.");
+}
 
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// The LLVM-level signature of a runtime function, computed on first use and
+// shared by all modules the function is declared in.
+struct RTSignature {
+  std::string symbolName;
+  llvm::FunctionType *type = nullptr;
+  AttrSet attrs;
+  llvm::CallingConv::ID callingConv = llvm::CallingConv::C;
+};
 
-  // void invariant._d_invariant(Object o)
-  createFwdDecl(
-      LINKd, voidTy,
-      {gABI->mangleFunctionForLLVM("_D9invariant12_d_invariantFC6ObjectZv", LINKd)},
-      {objectTy});
+RTSignature *signatures = nullptr;
 
-  // void _d_dso_registry(CompilerDSOData* data)
-  llvm::StringRef fname("_d_dso_registry");
+// Maps the LLVM symbol names to the runtime function identifiers; only built
+// if a function is looked up by name.
+llvm::StringMap<RTFunc::Type> *namesToFunctions = nullptr;
 
+void buildDSORegistrySignature(RTSignature &sig) {
   LLType *LLvoidTy = LLType::getVoidTy(gIR->context());
   LLType *LLvoidPtrPtrTy = getPtrToType(getPtrToType(LLvoidTy));
   LLType *moduleInfoPtrPtrTy =
@@ -693,56 +817,123 @@ static void buildRuntimeModule() {
                             NULL);
 
   llvm::Type *types[] = {getPtrToType(dsoDataTy)};
-  llvm::FunctionType *fty = llvm::FunctionType::get(LLvoidTy, types, false);
-  llvm::Function::Create(fty, llvm::GlobalValue::ExternalLinkage, fname, M);
-
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////////////////
-
-  // extern (C) void _d_cover_register2(string filename, size_t[] valid,
-  //                                    uint[] data, ubyte minPercent)
-  if (global.params.cov) {
-    createFwdDecl(LINKc, voidTy, {"_d_cover_register2"},
-                  {stringTy, sizeTy->arrayOf(), uintTy->arrayOf(), ubyteTy});
+  sig.type = llvm::FunctionType::get(LLvoidTy, types, false);
+}
+
+void buildSignature(const RTFunctionDesc &desc, RTSignature &sig) {
+  Logger::println("building runtime declaration for %s", desc.name);
+  LOG_SCOPE;
+
+  sig.symbolName = gABI->mangleFunctionForLLVM(desc.name, desc.linkage);
+
+  if (desc.id == RTFunc::_d_dso_registry) {
+    buildDSORegistrySignature(sig);
+    return;
   }
 
-  if (global.params.hasObjectiveC) {
-    assert(global.params.targetTriple->isOSDarwin());
+  Parameters *params = nullptr;
+  if (desc.paramTypes[0] != RTType::None) {
+    params = new Parameters();
+    for (unsigned i = 0; i < MaxRTParams && desc.paramTypes[i] != RTType::None;
+         ++i) {
+      params->push(Parameter::create(desc.paramsSTC[i],
+                                     getRTType(desc.paramTypes[i]), nullptr,
+                                     nullptr));
+    }
+  }
+  int varargs = 0;
+  auto dty = TypeFunction::create(params, getRTType(desc.returnType), varargs,
+                                  desc.linkage);
 
-    // The types of these functions don't really matter because they are always
-    // bitcast to correct signature before calling.
-    Type* objectPtrTy = voidPtrTy;
-    Type* selectorPtrTy = voidPtrTy;
-    Type* realTy = Type::tfloat80;
+  // the call to DtoType performs many actions such as rewriting the function
+  // type and storing it in dty
+  sig.type = llvm::cast<llvm::FunctionType>(DtoType(dty));
+  assert(dty->ctype);
+  sig.attrs =
+      dty->ctype->getIrFuncTy().getParamAttrs(gABI->passThisBeforeSret(dty));
+  sig.attrs.merge(getRTAttrs(desc.attrs));
+
+  // On x86_64, always set 'uwtable' for System V ABI compatibility.
+  // FIXME: Move to better place (abi-x86-64.cpp?)
+  // NOTE: There are several occurances if this line.
+  if (global.params.targetTriple->getArch() == llvm::Triple::x86_64) {
+    sig.attrs = AttrSet(sig.attrs, llvm::AttributeSet::FunctionIndex,
+                        LLAttribute::UWTable);
+  }
 
-    // id objc_msgSend(id self, SEL op, ...)
-    // Function called early and/or often, so lazy binding isn't worthwhile.
-    createFwdDecl(LINKc, objectPtrTy, {"objc_msgSend"},
-                  {objectPtrTy, selectorPtrTy}, {},
-                  AttrSet(NoAttrs, ~0U, llvm::Attribute::NonLazyBind));
-
-    switch (global.params.targetTriple->getArch()) {
-    case llvm::Triple::x86_64:
-      // creal objc_msgSend_fp2ret(id self, SEL op, ...)
-      createFwdDecl(LINKc, Type::tcomplex80, {"objc_msgSend_fp2ret"},
-                    {objectPtrTy, selectorPtrTy});
-      // fall-thru
-    case llvm::Triple::x86:
-      // x86_64 real return only,  x86 float, double, real return
-      // real objc_msgSend_fpret(id self, SEL op, ...)
-      createFwdDecl(LINKc, realTy, {"objc_msgSend_fpret"},
-                    {objectPtrTy, selectorPtrTy});
-      // fall-thru
-    case llvm::Triple::arm:
-    case llvm::Triple::thumb:
-      // used when return value is aggregate via a hidden sret arg
-      // void objc_msgSend_stret(T *sret_arg, id self, SEL op, ...)
-      createFwdDecl(LINKc, voidTy, {"objc_msgSend_stret"},
-                    {objectPtrTy, selectorPtrTy});
-      break;
-    default:
-      break;
+  sig.callingConv = gABI->callingConv(sig.type, desc.linkage);
+}
+
+const RTSignature &getSignature(RTFunc::Type id) {
+  if (!signatures) {
+    initRuntime();
+  }
+
+  RTSignature &sig = signatures[id];
+  if (!sig.type) {
+    buildSignature(lookupRuntimeFunction(id), sig);
+  }
+  return sig;
+}
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool initRuntime() {
+  if (!signatures) {
+    Logger::println("*** Initializing D runtime declarations ***");
+    signatures = new RTSignature[RTFunc::NumFunctions];
+  }
+  return true;
+}
+
+void freeRuntime() {
+  if (signatures) {
+    Logger::println("*** Freeing D runtime declarations ***");
+    delete[] signatures;
+    signatures = nullptr;
+  }
+  delete namesToFunctions;
+  namesToFunctions = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+llvm::Function *getRuntimeFunction(const Loc &loc, llvm::Module &target,
+                                   RTFunc::Type fn) {
+  assert(runtimeFunctions[fn].id == fn &&
+         "Runtime function table out of sync with RTFunc::Type");
+  checkForImplicitGCCall(loc, runtimeFunctions[fn].name);
+
+  const RTSignature &sig = getSignature(fn);
+
+  if (LLFunction *existing = target.getFunction(sig.symbolName)) {
+    return existing;
+  }
+
+  LLFunction *resfn = LLFunction::Create(
+      sig.type, llvm::GlobalValue::ExternalLinkage, sig.symbolName, &target);
+  resfn->setAttributes(sig.attrs);
+  resfn->setCallingConv(sig.callingConv);
+  return resfn;
+}
+
+llvm::Function *getRuntimeFunction(const Loc &loc, llvm::Module &target,
+                                   const char *name) {
+  if (!namesToFunctions) {
+    namesToFunctions = new llvm::StringMap<RTFunc::Type>();
+    for (unsigned i = 0; i < RTFunc::NumFunctions; ++i) {
+      const RTFunctionDesc &desc = runtimeFunctions[i];
+      (*namesToFunctions)[gABI->mangleFunctionForLLVM(desc.name,
+                                                      desc.linkage)] = desc.id;
     }
   }
+
+  auto it = namesToFunctions->find(name);
+  if (it == namesToFunctions->end()) {
+    error(loc, "Runtime function '%s' was not found", name);
+    fatal();
+  }
+
+  return getRuntimeFunction(loc, target, it->second);
 }
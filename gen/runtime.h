@@ -16,20 +16,156 @@
 
 namespace llvm {
 class Function;
-class GlobalVariable;
 class Module;
 }
 
 struct Loc;
 
+// The D runtime functions known to the compiler. Remember to keep this enum
+// in-sync with the signature table in runtime.cpp.
+namespace RTFunc {
+enum Type {
+  // assertions and bounds checks
+  _d_assert,
+  _d_arraybounds,
+  _d_assert_msg,
+  _d_assertm,
+  _d_array_bounds,
+  _d_switch_error,
+
+  // memory allocation and arrays
+  _d_allocmemory,
+  _d_allocmemoryT,
+  _d_newarrayT,
+  _d_newarrayiT,
+  _d_newarrayU,
+  _d_newarraymTX,
+  _d_newarraymiTX,
+  _d_arraysetlengthT,
+  _d_arraysetlengthiT,
+  _d_arrayappendcTX,
+  _d_arrayappendT,
+  _d_arrayappendcd,
+  _d_arrayappendwd,
+  _d_arraycatT,
+  _d_arraycatnTX,
+  _d_newclass,
+  _d_newitemT,
+  _d_newitemiT,
+  _d_delarray_t,
+  _d_delmemory,
+  _d_delinterface,
+  _d_callfinalizer,
+  _d_delclass,
+  _d_delstruct,
+  _d_array_slice_copy,
+
+  // foreach over strings
+  _aApplycw1,
+  _aApplycd1,
+  _aApplyRcw1,
+  _aApplyRcd1,
+  _aApplywc1,
+  _aApplywd1,
+  _aApplyRwc1,
+  _aApplyRwd1,
+  _aApplydc1,
+  _aApplydw1,
+  _aApplyRdc1,
+  _aApplyRdw1,
+  _aApplycw2,
+  _aApplycd2,
+  _aApplyRcw2,
+  _aApplyRcd2,
+  _aApplywc2,
+  _aApplywd2,
+  _aApplyRwc2,
+  _aApplyRwd2,
+  _aApplydc2,
+  _aApplydw2,
+  _aApplyRdc2,
+  _aApplyRdw2,
+
+  // array casts, assignment and construction
+  _d_array_cast_len,
+  _d_arrayassign_l,
+  _d_arrayassign_r,
+  _d_arrayctor,
+  _d_arraysetassign,
+  _d_arraysetctor,
+
+  // casts
+  _d_interface_cast,
+  _d_dynamic_cast,
+
+  // array properties and comparisons
+  _adReverseChar,
+  _adSortChar,
+  _adReverseWchar,
+  _adSortWchar,
+  _adReverse,
+  _adEq2,
+  _adCmp2,
+  _adCmpChar,
+  _adSort,
+
+  // associative arrays
+  _aaLen,
+  _aaGetY,
+  _aaInX,
+  _aaDelX,
+  _aaValues,
+  _aaRehash,
+  _aaKeys,
+  _aaApply,
+  _aaApply2,
+  _aaEqual,
+  _d_assocarrayliteralTX,
+
+  // module constructors, exceptions and switches
+  _moduleCtor,
+  _moduleDtor,
+  _d_throw_exception,
+  _d_switch_string,
+  _d_switch_ustring,
+  _d_switch_dstring,
+
+  // exception handling
+  _d_eh_personality,
+  __CxxFrameHandler3,
+  _d_enter_cleanup,
+  _d_leave_cleanup,
+  _d_eh_enter_catch,
+  _d_eh_resume_unwind,
+
+  // miscellaneous
+  _d_invariant,
+  _d_dso_registry,
+  _d_cover_register2,
+
+  // Objective-C
+  objc_msgSend,
+  objc_msgSend_fp2ret,
+  objc_msgSend_fpret,
+  objc_msgSend_stret,
+
+  NumFunctions
+};
+}
+
 // D runtime support helpers
 bool initRuntime();
 void freeRuntime();
 
+/// Returns the declaration of the given D runtime function in the target
+/// module. The declaration is only created the first time it is requested.
 llvm::Function *getRuntimeFunction(const Loc &loc, llvm::Module &target,
-                                          const char *name);
+                                   RTFunc::Type fn);
 
-llvm::GlobalVariable *
-getRuntimeGlobal(const Loc &loc, llvm::Module &target, const char *name);
+/// Looks up a D runtime function by its (LLVM-mangled) symbol name.
+/// Prefer the overload taking an RTFunc::Type where the function is known
+/// statically.
+llvm::Function *getRuntimeFunction(const Loc &loc, llvm::Module &target,
+                                   const char *name);
 
 #endif // LDC_GEN_RUNTIME_H
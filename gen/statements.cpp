@@ -62,13 +62,13 @@ static LLValue *call_string_switch_runtime(llvm::Value *table, Expression *e) {
   Type *dt = e->type->toBasetype();
   Type *dtnext = dt->nextOf()->toBasetype();
   TY ty = dtnext->ty;
-  const char *fname;
+  RTFunc::Type fname;
   if (ty == Tchar) {
-    fname = "_d_switch_string";
+    fname = RTFunc::_d_switch_string;
   } else if (ty == Twchar) {
-    fname = "_d_switch_ustring";
+    fname = RTFunc::_d_switch_ustring;
   } else if (ty == Tdchar) {
-    fname = "_d_switch_dstring";
+    fname = RTFunc::_d_switch_dstring;
   } else {
     llvm_unreachable("not char/wchar/dchar");
   }
@@ -880,7 +880,7 @@ public:
     llvm::CatchReturnInst::Create(catchpad, catchhandler, irs->scopebb());
     irs->scope() = IRScope(catchhandler);
     auto enterCatchFn =
-        getRuntimeFunction(Loc(), irs->module, "_d_eh_enter_catch");
+        getRuntimeFunction(Loc(), irs->module, RTFunc::_d_eh_enter_catch);
     irs->CreateCallOrInvoke(enterCatchFn, DtoBitCast(exnObj, getVoidPtrType()),
                             clssInfo);
   }
@@ -968,9 +968,8 @@ public:
       // the verifier complains if there are catchpads without personality
       // so we can just set it unconditionally
       if (!irs->func()->func->hasPersonalityFn()) {
-        const char *personality = "__CxxFrameHandler3";
-        LLFunction *personalityFn =
-            getRuntimeFunction(Loc(), irs->module, personality);
+        LLFunction *personalityFn = getRuntimeFunction(
+            Loc(), irs->module, RTFunc::__CxxFrameHandler3);
         irs->func()->func->setPersonalityFn(personalityFn);
       }
     } else
@@ -988,7 +987,7 @@ public:
         PGO.emitCounterIncrement(*it);
 
         const auto enterCatchFn =
-            getRuntimeFunction(Loc(), irs->module, "_d_eh_enter_catch");
+            getRuntimeFunction(Loc(), irs->module, RTFunc::_d_eh_enter_catch);
         auto ptr = DtoLoad(irs->func()->getOrCreateEhPtrSlot());
         auto throwableObj = irs->ir->CreateCall(enterCatchFn, ptr);
 
@@ -1095,7 +1094,7 @@ public:
     DValue *e = toElemDtor(stmt->exp);
 
     llvm::Function *fn =
-        getRuntimeFunction(stmt->loc, irs->module, "_d_throw_exception");
+        getRuntimeFunction(stmt->loc, irs->module, RTFunc::_d_throw_exception);
     LLValue *arg =
         DtoBitCast(DtoRVal(e), fn->getFunctionType()->getParamType(0));
 
@@ -1932,7 +1931,7 @@ public:
     PGO.setCurrentStmt(stmt);
 
     llvm::Function *fn =
-        getRuntimeFunction(stmt->loc, irs->module, "_d_switch_error");
+        getRuntimeFunction(stmt->loc, irs->module, RTFunc::_d_switch_error);
 
     LLValue *moduleInfoSymbol =
         getIrModule(irs->func()->decl->getModule())->moduleInfoSymbol();
@@ -0,0 +1,315 @@
+//===-- targetclones.cpp --------------------------------------------------===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// For a function marked with @target_clones("default", "avx2", "avx512f"),
+// the body is cloned once per (non-default) target spec and compiled with the
+// corresponding target features. The original symbol then dispatches to the
+// best clone for the host CPU:
+//
+//  * On ELF targets (with LLVM >= 3.9), the symbol is a GNU ifunc whose
+//    resolver is run by the dynamic linker.
+//  * Elsewhere, the symbol is a thunk tail-calling through a function pointer,
+//    which initially points to the default clone and is set by a global
+//    constructor.
+//
+// The resolver checks the host CPU features using the __cpu_model variable of
+// libgcc/compiler-rt (like clang's and GCC's __builtin_cpu_supports). The
+// specs are tried from last to first, so that more specific targets should be
+// listed last; the "default" clone is used if none of them is supported.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gen/targetclones.h"
+#include "declaration.h"
+#include "gen/irstate.h"
+#include "gen/llvm.h"
+#include "gen/llvmhelpers.h"
+#include "gen/logger.h"
+#include "gen/tollvm.h"
+#include "gen/uda.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#if LDC_LLVM_VER >= 309
+#include "llvm/IR/GlobalIFunc.h"
+#endif
+
+namespace {
+
+/// Returns the bit of the given feature in __cpu_model.__cpu_features[0], or
+/// -1 if the feature can't be checked at runtime.
+int getCPUFeatureBit(llvm::StringRef feature) {
+  return llvm::StringSwitch<int>(feature)
+      .Case("cmov", 0)
+      .Case("mmx", 1)
+      .Case("popcnt", 2)
+      .Case("sse", 3)
+      .Case("sse2", 4)
+      .Case("sse3", 5)
+      .Case("ssse3", 6)
+      .Case("sse4.1", 7)
+      .Case("sse4.2", 8)
+      .Case("avx", 9)
+      .Case("avx2", 10)
+      .Case("sse4a", 11)
+      .Case("fma4", 12)
+      .Case("xop", 13)
+      .Case("fma", 14)
+      .Case("avx512f", 15)
+      .Case("bmi", 16)
+      .Case("bmi2", 17)
+      .Case("aes", 18)
+      .Case("pclmul", 19)
+      .Case("avx512vl", 20)
+      .Case("avx512bw", 21)
+      .Case("avx512dq", 22)
+      .Case("avx512cd", 23)
+      .Case("avx512er", 24)
+      .Case("avx512pf", 25)
+      .Case("avx512vbmi", 26)
+      .Case("avx512ifma", 27)
+      .Default(-1);
+}
+
+/// Computes the mask of CPU feature bits required by a target spec. Returns
+/// false (after emitting an error) if the spec can't be dispatched on.
+bool getCPUFeatureMask(FuncDeclaration *decl, llvm::StringRef spec,
+                       uint32_t &mask) {
+  mask = 0;
+  llvm::SmallVector<llvm::StringRef, 4> fragments;
+  llvm::SplitString(spec, fragments, ",");
+  for (auto s : fragments) {
+    s = s.trim();
+    // Disabled features and tuning don't need to be checked.
+    if (s.empty() || s == "default" || s.startswith("no-") ||
+        s.startswith("tune=") || s.startswith("fpmath=")) {
+      continue;
+    }
+
+    const int bit = getCPUFeatureBit(s);
+    if (bit < 0) {
+      decl->error("target '%s' of @ldc.attributes.target_clones cannot be "
+                  "detected at runtime",
+                  s.str().c_str());
+      return false;
+    }
+    mask |= 1u << bit;
+  }
+  return true;
+}
+
+std::string getCloneSuffix(llvm::StringRef spec) {
+  std::string suffix = spec;
+  for (auto &c : suffix) {
+    if (!llvm::isAlnum(c)) {
+      c = '_';
+    }
+  }
+  return suffix;
+}
+
+llvm::Function *cloneFunction(llvm::Function *func) {
+  llvm::ValueToValueMapTy vmap;
+#if LDC_LLVM_VER >= 309
+  return llvm::CloneFunction(func, vmap);
+#else
+  llvm::Function *clone = llvm::CloneFunction(func, vmap, false);
+  func->getParent()->getFunctionList().push_back(clone);
+  return clone;
+#endif
+}
+
+/// Builds the resolver returning the clone to use for the host CPU.
+llvm::Function *
+buildResolver(llvm::Function *defaultClone,
+              const std::vector<std::pair<llvm::Function *, uint32_t>> &clones,
+              const llvm::Twine &name) {
+  llvm::LLVMContext &context = gIR->context();
+  llvm::Module &module = gIR->module;
+  LLType *i32 = LLType::getInt32Ty(context);
+  LLPointerType *fnPtrType = defaultClone->getType();
+
+  auto resolver = llvm::Function::Create(
+      llvm::FunctionType::get(fnPtrType, false),
+      llvm::GlobalValue::InternalLinkage, name, &module);
+  llvm::IRBuilder<> builder(
+      llvm::BasicBlock::Create(context, "entry", resolver));
+
+  // The resolver may run before any global constructor (for ifuncs), so
+  // __cpu_model needs to be initialized explicitly.
+  llvm::Constant *initFn = module.getOrInsertFunction(
+      "__cpu_indicator_init", LLType::getVoidTy(context), nullptr);
+#if LDC_LLVM_VER >= 307
+  builder.CreateCall(initFn, {});
+#else
+  builder.CreateCall(initFn, "");
+#endif
+
+  // struct __processor_model {
+  //   unsigned __cpu_vendor, __cpu_type, __cpu_subtype;
+  //   unsigned __cpu_features[1];
+  // }
+  LLType *elems[] = {i32, i32, i32, llvm::ArrayType::get(i32, 1)};
+  LLStructType *cpuModelType = LLStructType::get(context, elems);
+  llvm::Constant *cpuModel =
+      module.getOrInsertGlobal("__cpu_model", cpuModelType);
+  LLValue *idxs[] = {DtoConstUint(0), DtoConstUint(3), DtoConstUint(0)};
+  LLValue *features =
+      builder.CreateLoad(builder.CreateInBoundsGEP(cpuModel, idxs));
+
+  for (auto it = clones.rbegin(), end = clones.rend(); it != end; ++it) {
+    LLValue *mask = llvm::ConstantInt::get(i32, it->second);
+    LLValue *supported =
+        builder.CreateICmpEQ(builder.CreateAnd(features, mask), mask);
+    auto retBB = llvm::BasicBlock::Create(context, "supported", resolver);
+    auto nextBB = llvm::BasicBlock::Create(context, "next", resolver);
+    builder.CreateCondBr(supported, retBB, nextBB);
+    builder.SetInsertPoint(retBB);
+    builder.CreateRet(it->first);
+    builder.SetInsertPoint(nextBB);
+  }
+  builder.CreateRet(defaultClone);
+
+  return resolver;
+}
+
+/// Replaces the default clone (renamed) by a thunk calling through a function
+/// pointer, set by a global constructor.
+void emitTrampoline(
+    llvm::Function *defaultClone,
+    const std::vector<std::pair<llvm::Function *, uint32_t>> &clones,
+    const std::string &name, llvm::GlobalValue::LinkageTypes linkage,
+    llvm::GlobalValue::VisibilityTypes visibility,
+    llvm::GlobalValue::DLLStorageClassTypes dllStorage) {
+  llvm::LLVMContext &context = gIR->context();
+  llvm::Module &module = gIR->module;
+
+  auto thunk = llvm::Function::Create(defaultClone->getFunctionType(), linkage,
+                                      name, &module);
+  thunk->copyAttributesFrom(defaultClone);
+  thunk->setVisibility(visibility);
+  thunk->setDLLStorageClass(dllStorage);
+  defaultClone->replaceAllUsesWith(thunk);
+
+  // Only created after redirecting the uses, as the pointer and the resolver
+  // must refer to the default clone itself, not to the thunk.
+  auto fnPtr = new llvm::GlobalVariable(
+      module, defaultClone->getType(), false,
+      llvm::GlobalValue::InternalLinkage, defaultClone, name + ".ptr");
+  llvm::Function *resolver =
+      buildResolver(defaultClone, clones, name + ".resolver");
+
+  {
+    llvm::IRBuilder<> builder(
+        llvm::BasicBlock::Create(context, "entry", thunk));
+    llvm::SmallVector<LLValue *, 8> args;
+    for (auto &arg : thunk->args()) {
+      args.push_back(&arg);
+    }
+    llvm::CallInst *call = builder.CreateCall(builder.CreateLoad(fnPtr), args);
+    call->setCallingConv(defaultClone->getCallingConv());
+    call->setAttributes(defaultClone->getAttributes());
+    call->setTailCallKind(llvm::CallInst::TCK_MustTail);
+    if (call->getType()->isVoidTy()) {
+      builder.CreateRetVoid();
+    } else {
+      builder.CreateRet(call);
+    }
+  }
+
+  auto init = llvm::Function::Create(
+      llvm::FunctionType::get(LLType::getVoidTy(context), false),
+      llvm::GlobalValue::InternalLinkage, name + ".init", &module);
+  {
+    llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", init));
+#if LDC_LLVM_VER >= 307
+    builder.CreateStore(builder.CreateCall(resolver, {}), fnPtr);
+#else
+    builder.CreateStore(builder.CreateCall(resolver, ""), fnPtr);
+#endif
+    builder.CreateRetVoid();
+  }
+  AppendFunctionToLLVMGlobalCtorsDtors(init, 0, true);
+}
+
+void emitTargetClones(IRState *irs, TargetClones &tc) {
+  llvm::Function *func = tc.func;
+  if (func->isDeclaration() || func->hasAvailableExternallyLinkage()) {
+    return;
+  }
+
+  IF_LOG Logger::println("Emitting target clones for %s",
+                         tc.decl->toPrettyChars());
+  LOG_SCOPE;
+
+  const llvm::Triple &triple = *global.params.targetTriple;
+  if ((triple.getArch() != llvm::Triple::x86 &&
+       triple.getArch() != llvm::Triple::x86_64) ||
+      triple.isWindowsMSVCEnvironment()) {
+    tc.decl->error("@ldc.attributes.target_clones is only supported for x86 "
+                   "targets with a GNU-compatible runtime (libgcc or "
+                   "compiler-rt)");
+    return;
+  }
+
+  std::vector<std::pair<llvm::StringRef, uint32_t>> specs;
+  for (auto &spec : tc.specs) {
+    uint32_t mask;
+    if (!getCPUFeatureMask(tc.decl, spec, mask)) {
+      return;
+    }
+    if (mask != 0) {
+      specs.push_back(std::make_pair(llvm::StringRef(spec), mask));
+    }
+  }
+
+  // The original function becomes the default clone; its symbol properties
+  // are transferred to the dispatcher.
+  const std::string name = func->getName();
+  const auto linkage = func->getLinkage();
+  const auto visibility = func->getVisibility();
+  const auto dllStorage = func->getDLLStorageClass();
+  func->setName(name + ".default");
+  func->setLinkage(llvm::GlobalValue::InternalLinkage);
+  func->setVisibility(llvm::GlobalValue::DefaultVisibility);
+  func->setDLLStorageClass(llvm::GlobalValue::DefaultStorageClass);
+#if LDC_LLVM_VER >= 307
+  func->setComdat(nullptr);
+#endif
+
+  std::vector<std::pair<llvm::Function *, uint32_t>> clones;
+  for (auto &spec : specs) {
+    llvm::Function *clone = cloneFunction(func);
+    clone->setName(name + "." + getCloneSuffix(spec.first));
+    applyTargetSpec(spec.first, clone);
+    clones.push_back(std::make_pair(clone, spec.second));
+  }
+
+  const bool useIFunc = LDC_LLVM_VER >= 309 && triple.isOSBinFormatELF();
+  if (!useIFunc) {
+    emitTrampoline(func, clones, name, linkage, visibility, dllStorage);
+  } else {
+#if LDC_LLVM_VER >= 309
+    auto ifunc = llvm::GlobalIFunc::create(func->getFunctionType(), 0, linkage,
+                                           "", nullptr, &irs->module);
+    ifunc->setVisibility(visibility);
+    func->replaceAllUsesWith(ifunc);
+    ifunc->setName(name);
+    ifunc->setResolver(buildResolver(func, clones, name + ".resolver"));
+#endif
+  }
+}
+}
+
+void emitTargetClones(IRState *irs) {
+  for (auto &tc : irs->targetClones) {
+    emitTargetClones(irs, tc);
+  }
+  irs->targetClones.clear();
+}
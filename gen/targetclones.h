@@ -0,0 +1,24 @@
+//===-- gen/targetclones.h - Function multiversioning -----------*- C++ -*-===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Emits one clone per target for functions with @target_clones, plus runtime
+// dispatch to the best clone for the host CPU.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LDC_GEN_TARGETCLONES_H
+#define LDC_GEN_TARGETCLONES_H
+
+struct IRState;
+
+/// Multiversions all functions defined in the module that have been marked
+/// with @target_clones.
+void emitTargetClones(IRState *irs);
+
+#endif
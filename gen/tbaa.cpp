@@ -0,0 +1,124 @@
+//===-- tbaa.cpp ----------------------------------------------------------===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// The type tree is flat: all scalar type nodes are children of a single root.
+// Signed and unsigned integers of the same size share a node (as in C), as do
+// all pointers and class references. Accesses of byte-sized types (incl. char
+// and bool) aren't tagged, so that they may alias everything (like C's char).
+//
+//===----------------------------------------------------------------------===//
+
+#include "gen/tbaa.h"
+#include "aggregate.h"
+#include "declaration.h"
+#include "mtype.h"
+#include "driver/cl_options.h"
+#include "gen/dvalue.h"
+#include "gen/irstate.h"
+#include "ir/irfunction.h"
+#include "llvm/IR/MDBuilder.h"
+
+namespace {
+
+/// Returns the name of the TBAA type node for accesses of the given D type,
+/// or null if such accesses may alias everything.
+const char *getTypeNodeName(Type *type) {
+  Type *t = type->toBasetype();
+  if (t->ty == Tvector) {
+    // Vectors alias their elements.
+    t = static_cast<TypeVector *>(t)->basetype->nextOf()->toBasetype();
+  }
+
+  switch (t->ty) {
+  case Tint16:
+  case Tuns16:
+  case Twchar:
+    return "short";
+  case Tint32:
+  case Tuns32:
+  case Tdchar:
+    return "int";
+  case Tint64:
+  case Tuns64:
+    return "long";
+  case Tint128:
+  case Tuns128:
+    return "cent";
+  case Tfloat32:
+  case Timaginary32:
+    return "float";
+  case Tfloat64:
+  case Timaginary64:
+    return "double";
+  case Tfloat80:
+  case Timaginary80:
+    return "real";
+  case Tpointer:
+  case Tclass:
+  case Tnull:
+    return "any pointer";
+  default:
+    return nullptr;
+  }
+}
+
+llvm::MDNode *getAccessTag(const char *typeNodeName) {
+  llvm::MDNode *&tag = gIR->TBAAAccessTags[typeNodeName];
+  if (!tag) {
+    llvm::MDBuilder mdb(gIR->context());
+    if (!gIR->TBAARoot) {
+      gIR->TBAARoot = mdb.createTBAARoot("D TBAA");
+    }
+    llvm::MDNode *typeNode =
+        mdb.createTBAAScalarTypeNode(typeNodeName, gIR->TBAARoot);
+    tag = mdb.createTBAAStructTagNode(typeNode, typeNode, 0);
+  }
+  return tag;
+}
+
+/// Explicitly @system functions are the escape hatch for type punning via
+/// pointer casts.
+bool emitTBAAMetadata() {
+  if (!opts::strictAliasing || gIR->functions.empty()) {
+    return false;
+  }
+
+  Type *t = gIR->func()->decl->type;
+  return t->ty != Tfunction ||
+         static_cast<TypeFunction *>(t)->trust != TRUSTsystem;
+}
+}
+
+void addTBAAMetadata(llvm::Value *access, DLValue *lval) {
+  auto inst = llvm::dyn_cast<llvm::Instruction>(access);
+  if (!inst || lval->mayAlias || !emitTBAAMetadata()) {
+    return;
+  }
+
+  if (const char *typeNodeName = getTypeNodeName(lval->type)) {
+    inst->setMetadata(llvm::LLVMContext::MD_tbaa, getAccessTag(typeNodeName));
+  }
+}
+
+bool isOverlappingField(VarDeclaration *vd) {
+  if (vd->overlapped) {
+    return true;
+  }
+
+  AggregateDeclaration *ad = vd->isThis();
+  if (!ad) {
+    return false;
+  }
+  for (auto field : ad->fields) {
+    if (field != vd && vd->isOverlappedWith(field)) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,34 @@
+//===-- gen/tbaa.h - Type-based alias analysis metadata ---------*- C++ -*-===//
+//
+//                         LDC – the LLVM D compiler
+//
+// This file is distributed under the BSD-style LDC license. See the LICENSE
+// file for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Attaches TBAA metadata derived from the D type system to loads and stores
+// if -fstrict-aliasing is enabled.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LDC_GEN_TBAA_H
+#define LDC_GEN_TBAA_H
+
+class DLValue;
+class VarDeclaration;
+namespace llvm {
+class Value;
+}
+
+/// Attaches a TBAA access tag to the given load or store of the D lvalue
+/// \p lval. Nothing is done unless -fstrict-aliasing is enabled, if the
+/// current function is explicitly @system, for byte-sized and aggregate types
+/// (which may alias everything) and for union members.
+void addTBAAMetadata(llvm::Value *access, DLValue *lval);
+
+/// Returns true if the given field overlaps with another one, i.e. is a union
+/// member.
+bool isOverlappingField(VarDeclaration *vd);
+
+#endif
@@ -819,8 +819,9 @@ DValue *DtoCallFunction(Loc &loc, Type *resulttype, DValue *fnval,
   // parameter attributes
   AttrSet attrs;
 
-  // return attrs
+  // return and function attrs
   attrs.add(0, irFty.ret->attrs);
+  attrs.add(llvm::AttributeSet::FunctionIndex, irFty.fnAttrs);
 
   std::vector<LLValue *> args;
   args.reserve(irFty.args.size());
@@ -885,7 +886,10 @@ DValue *DtoCallFunction(Loc &loc, Type *resulttype, DValue *fnval,
   }
 
   // call the function
-  LLCallSite call = gIR->func()->scopes->callOrInvoke(callable, args);
+  // nothrow callees (incl. inferred ones, for which the LLVM function might
+  // have been declared before the inference) don't need to be invoked.
+  LLCallSite call =
+      gIR->func()->scopes->callOrInvoke(callable, args, "", tf->isnothrow);
 
   // get return value
   const int sretArgIndex =
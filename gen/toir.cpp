@@ -11,6 +11,7 @@
 #include "enum.h"
 #include "gen/aa.h"
 #include "gen/abi.h"
+#include "gen/arrayops.h"
 #include "gen/arrays.h"
 #include "gen/binops.h"
 #include "gen/classes.h"
@@ -28,6 +29,7 @@
 #include "gen/pragma.h"
 #include "gen/runtime.h"
 #include "gen/structs.h"
+#include "gen/tbaa.h"
 #include "gen/tollvm.h"
 #include "gen/typinf.h"
 #include "gen/warnings.h"
@@ -43,6 +45,7 @@
 #include "port.h"
 #include "rmem.h"
 #include "template.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ManagedStatic.h"
 #include <fstream>
@@ -189,6 +192,98 @@ void pushVarDtorCleanup(IRState *p, VarDeclaration *vd) {
   p->func()->scopes->pushCleanup(beginBB, p->scopebb());
   p->scope() = oldScope;
 }
+
+/// Checks whether the elements of vector literal `lit` are all constant-index
+/// reads of (the `.array` of) at most two variables of vector type `type`,
+/// e.g. `[a.array[3], b.array[0], ...]`. If so, returns the variables in
+/// `sources` and the indices into their concatenation in `mask`.
+bool isVectorShuffle(ArrayLiteralExp *lit, TypeVector *type,
+                     llvm::SmallVectorImpl<VarExp *> &sources,
+                     llvm::SmallVectorImpl<unsigned> &mask) {
+  const unsigned dim = lit->elements->dim;
+  for (unsigned i = 0; i < dim; ++i) {
+    Expression *el = indexArrayLiteral(lit, i);
+    if (el->op != TOKindex) {
+      return false;
+    }
+    IndexExp *ie = static_cast<IndexExp *>(el);
+    if (ie->e1->op != TOKcast || ie->e2->op != TOKint64) {
+      return false;
+    }
+    Expression *src = static_cast<CastExp *>(ie->e1)->e1;
+    if (src->op != TOKvar || !src->type->toBasetype()->equals(type)) {
+      return false;
+    }
+    const uinteger_t idx = ie->e2->toInteger();
+    if (idx >= dim) {
+      return false;
+    }
+
+    VarExp *ve = static_cast<VarExp *>(src);
+    unsigned s = 0;
+    while (s < sources.size() && sources[s]->var != ve->var) {
+      ++s;
+    }
+    if (s == sources.size()) {
+      if (s == 2) {
+        return false;
+      }
+      sources.push_back(ve);
+    }
+    mask.push_back(s * dim + static_cast<unsigned>(idx));
+  }
+  return true;
+}
+
+/// Emits an element-wise comparison of the vectors `l` and `r`, yielding a
+/// vector of type `resultType` with all bits of an element set if the
+/// comparison holds for it.
+LLValue *emitVectorComparison(IRState *p, TOK op, Type *resultType, DValue *l,
+                              DValue *r) {
+  TypeVector *tv = static_cast<TypeVector *>(l->type->toBasetype());
+  Type *elemType = tv->elementType();
+
+  LLValue *lv = DtoRVal(l);
+  LLValue *rv = DtoRVal(r);
+  LLValue *cmp;
+  if (elemType->isfloating()) {
+    llvm::FCmpInst::Predicate cmpop;
+    switch (op) {
+    case TOKlt:
+      cmpop = llvm::FCmpInst::FCMP_OLT;
+      break;
+    case TOKle:
+      cmpop = llvm::FCmpInst::FCMP_OLE;
+      break;
+    case TOKgt:
+      cmpop = llvm::FCmpInst::FCMP_OGT;
+      break;
+    case TOKge:
+      cmpop = llvm::FCmpInst::FCMP_OGE;
+      break;
+    case TOKequal:
+      cmpop = llvm::FCmpInst::FCMP_OEQ;
+      break;
+    case TOKnotequal:
+      cmpop = llvm::FCmpInst::FCMP_UNE;
+      break;
+    default:
+      llvm_unreachable("Unsupported vector comparison operator.");
+    }
+    cmp = p->ir->CreateFCmp(cmpop, lv, rv);
+  } else {
+    llvm::ICmpInst::Predicate cmpop;
+    if (op == TOKequal || op == TOKnotequal) {
+      cmpop = eqTokToICmpPred(op);
+    } else {
+      LLValue *dummy = nullptr;
+      tokToICmpPred(op, isLLVMUnsigned(elemType), &cmpop, &dummy);
+    }
+    cmp = p->ir->CreateICmp(cmpop, lv, rv);
+  }
+
+  return p->ir->CreateSExt(cmp, DtoType(resultType));
+}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -658,6 +753,11 @@ public:
         if (fd->llvmInternal == LLVMinline_ir) {
           return DtoInlineIRExpr(e->loc, fd, e->arguments);
         }
+        if (fd->isArrayOp) {
+          if (DValue *result = DtoInlineArrayOp(e->loc, fd, e->arguments)) {
+            return result;
+          }
+        }
       }
     }
 
@@ -940,7 +1040,15 @@ public:
       }
 
       // Logger::cout() << "mem: " << *arrptr << '\n';
-      result = new DLValue(e->type, DtoBitCast(arrptr, DtoPtrToType(e->type)));
+      auto field =
+          new DLValue(e->type, DtoBitCast(arrptr, DtoPtrToType(e->type)));
+      field->mayAlias =
+          isOverlappingField(vd) || (e1type->ty != Tpointer && l->isLVal() &&
+                                     l->isLVal()->mayAlias);
+      field->isInvariantGroup = e1type->ty == Tclass &&
+                                vd->type->isImmutable() &&
+                                !gIR->func()->decl->isCtorDeclaration();
+      result = field;
     } else if (FuncDeclaration *fdecl = e->var->isFuncDeclaration()) {
       DtoResolveFunction(fdecl);
 
@@ -1046,7 +1154,11 @@ public:
       IF_LOG Logger::println("e1type: %s", e1type->toChars());
       llvm_unreachable("Unknown IndexExp target.");
     }
-    result = new DLValue(e->type, DtoBitCast(arrptr, DtoPtrToType(e->type)));
+    auto elem = new DLValue(e->type, DtoBitCast(arrptr, DtoPtrToType(e->type)));
+    // Elements of static arrays in unions.
+    elem->mayAlias =
+        e1type->ty == Tsarray && l->isLVal() && l->isLVal()->mayAlias;
+    result = elem;
   }
 
   //////////////////////////////////////////////////////////////////////////////
@@ -1176,6 +1288,13 @@ public:
 
     Type *t = e->e1->type->toBasetype();
 
+    if (t->ty == Tvector) {
+      Logger::println("vector");
+      result = new DImValue(e->type,
+                            emitVectorComparison(p, e->op, e->type, l, r));
+      return;
+    }
+
     LLValue *eval = nullptr;
 
     if (t->isintegral() || t->ty == Tpointer || t->ty == Tnull) {
@@ -1307,6 +1426,13 @@ public:
 
     Type *t = e->e1->type->toBasetype();
 
+    if (t->ty == Tvector) {
+      Logger::println("vector");
+      result = new DImValue(e->type,
+                            emitVectorComparison(p, e->op, e->type, l, r));
+      return;
+    }
+
     LLValue *eval = nullptr;
 
     // the Tclass catches interface comparisons, regular
@@ -1666,11 +1792,8 @@ public:
         !(static_cast<TypeClass *>(condty)->sym->isInterfaceDeclaration()) &&
         !(static_cast<TypeClass *>(condty)->sym->isCPPclass())) {
       Logger::println("calling class invariant");
-      llvm::Function *fn = getRuntimeFunction(
-          e->loc, gIR->module,
-          gABI->mangleFunctionForLLVM("_D9invariant12_d_invariantFC6ObjectZv",
-                                      LINKd)
-              .c_str());
+      llvm::Function *fn =
+          getRuntimeFunction(e->loc, gIR->module, RTFunc::_d_invariant);
       LLValue *arg =
           DtoBitCast(DtoRVal(cond), fn->getFunctionType()->getParamType(0));
       gIR->CreateCallOrInvoke(fn, arg);
@@ -2432,8 +2555,8 @@ public:
       Type *indexType = static_cast<TypeAArray *>(aatype)->index;
       assert(indexType && vtype);
 
-      llvm::Function *func =
-          getRuntimeFunction(e->loc, gIR->module, "_d_assocarrayliteralTX");
+      llvm::Function *func = getRuntimeFunction(
+          e->loc, gIR->module, RTFunc::_d_assocarrayliteralTX);
       LLFunctionType *funcTy = func->getFunctionType();
       LLValue *aaTypeInfo =
           DtoBitCast(DtoTypeInfoOf(stripModifiers(aatype)),
@@ -2468,9 +2591,46 @@ public:
       slice = DtoConstSlice(DtoConstSize_t(e->keys->dim), slice);
       LLValue *valuesArray = DtoAggrPaint(slice, funcTy->getParamType(2));
 
-      LLValue *aa = gIR->CreateCallOrInvoke(func, aaTypeInfo, keysArray,
-                                            valuesArray, "aa")
-                        .getInstruction();
+      LLValue *aa;
+      if (basetype->isImmutable()) {
+        // An immutable AA built from constants can't be told apart from a
+        // fresh one, so build it only on the first evaluation and cache it
+        // in a global (which is scanned by the GC). Racing threads might
+        // both build it, which is harmless.
+        LLType *aaType = funcTy->getReturnType();
+        auto cache = new LLGlobalVariable(
+            gIR->module, aaType, false, LLGlobalValue::InternalLinkage,
+            llvm::Constant::getNullValue(aaType), ".aaLiteralCache");
+        LLValue *cached = DtoLoad(cache, "aa.cached");
+
+        llvm::BasicBlock *initbb = llvm::BasicBlock::Create(
+            gIR->context(), "aa.init", gIR->topfunc());
+        llvm::BasicBlock *endbb = llvm::BasicBlock::Create(
+            gIR->context(), "aa.end", gIR->topfunc());
+        llvm::BasicBlock *oldbb = p->scopebb();
+        LLValue *isNull = p->ir->CreateIsNull(cached);
+        llvm::MDBuilder mdb(gIR->context());
+        p->ir->CreateCondBr(isNull, initbb, endbb,
+                            mdb.createBranchWeights(1, 1000));
+
+        p->scope() = IRScope(initbb);
+        LLValue *built = gIR->CreateCallOrInvoke(func, aaTypeInfo, keysArray,
+                                                 valuesArray, "aa")
+                             .getInstruction();
+        DtoStore(built, cache);
+        llvm::BasicBlock *builtbb = p->scopebb();
+        llvm::BranchInst::Create(endbb, builtbb);
+
+        p->scope() = IRScope(endbb);
+        llvm::PHINode *phi = p->ir->CreatePHI(aaType, 2, "aa");
+        phi->addIncoming(cached, oldbb);
+        phi->addIncoming(built, builtbb);
+        aa = phi;
+      } else {
+        aa = gIR->CreateCallOrInvoke(func, aaTypeInfo, keysArray, valuesArray,
+                                     "aa")
+                 .getInstruction();
+      }
       if (basetype->ty != Taarray) {
         LLValue *tmp = DtoAlloca(e->type, "aaliteral");
         DtoStore(aa, DtoGEPi(tmp, 0, 0));
@@ -2607,31 +2767,50 @@ public:
     TypeVector *type = static_cast<TypeVector *>(e->to->toBasetype());
     assert(e->type->ty == Tvector);
 
-    LLValue *vector = DtoAlloca(e->to);
+    // The vector is built as an SSA value; IRBuilder folds it to a constant
+    // vector if all elements are constant.
+    LLValue *vector = nullptr;
 
     // Array literals are assigned element-wise, other expressions are cast and
     // splat across the vector elements. This is what DMD does.
     if (e->e1->op == TOKarrayliteral) {
-      Logger::println("array literal expression");
       ArrayLiteralExp *lit = static_cast<ArrayLiteralExp *>(e->e1);
       assert(lit->elements->dim == e->dim &&
              "Array literal vector initializer "
              "length mismatch, should have been handled in frontend.");
-      for (unsigned int i = 0; i < e->dim; ++i) {
-        DValue *val = toElem(indexArrayLiteral(lit, i));
-        LLValue *llval = DtoRVal(DtoCast(e->loc, val, type->elementType()));
-        DtoStore(llval, DtoGEPi(vector, 0, i));
+
+      llvm::SmallVector<VarExp *, 2> sources;
+      llvm::SmallVector<unsigned, 16> mask;
+      if (isVectorShuffle(lit, type, sources, mask)) {
+        Logger::println("shuffle of %u vector(s)",
+                        static_cast<unsigned>(sources.size()));
+        LLValue *v1 = DtoRVal(toElem(sources[0]));
+        LLValue *v2 = sources.size() > 1
+                          ? DtoRVal(toElem(sources[1]))
+                          : llvm::UndefValue::get(v1->getType());
+        llvm::SmallVector<LLConstant *, 16> indices;
+        for (unsigned idx : mask) {
+          indices.push_back(DtoConstUint(idx));
+        }
+        vector = p->ir->CreateShuffleVector(v1, v2,
+                                            llvm::ConstantVector::get(indices));
+      } else {
+        Logger::println("array literal expression");
+        vector = llvm::UndefValue::get(DtoType(e->to));
+        for (unsigned int i = 0; i < e->dim; ++i) {
+          DValue *val = toElem(indexArrayLiteral(lit, i));
+          LLValue *llval = DtoRVal(DtoCast(e->loc, val, type->elementType()));
+          vector = p->ir->CreateInsertElement(vector, llval, DtoConstUint(i));
+        }
       }
     } else {
       Logger::println("normal (splat) expression");
       DValue *val = toElem(e->e1);
       LLValue *llval = DtoRVal(DtoCast(e->loc, val, type->elementType()));
-      for (unsigned int i = 0; i < e->dim; ++i) {
-        DtoStore(llval, DtoGEPi(vector, 0, i));
-      }
+      vector = p->ir->CreateVectorSplat(e->dim, llval);
     }
 
-    result = new DLValue(e->to, vector);
+    result = new DImValue(e->to, vector);
   }
 
   //////////////////////////////////////////////////////////////////////////////
@@ -2659,7 +2838,7 @@ public:
       LLValue *val = DtoRVal(ex);
 
       // Get and load vtbl pointer.
-      llvm::Value *vtbl = DtoLoad(DtoGEPi(val, 0, 0));
+      llvm::Value *vtbl = DtoLoadVtbl(val);
 
       // TypeInfo ptr is first vtbl entry.
       llvm::Value *typinf = DtoGEPi(vtbl, 0, 0);
@@ -2672,6 +2851,7 @@ public:
         resultType = Type::typeinfointerface->type;
         typinf = DtoLoad(
             DtoBitCast(typinf, DtoType(resultType->pointerTo()->pointerTo())));
+        DtoSetInvariantLoad(typinf);
       }
 
       result = new DLValue(resultType, typinf);
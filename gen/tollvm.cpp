@@ -533,6 +533,12 @@ void DtoAlignedStore(LLValue *src, LLValue *dst) {
   st->setAlignment(getABITypeAlign(src->getType()));
 }
 
+void DtoSetInvariantLoad(LLValue *load) {
+  llvm::cast<llvm::LoadInst>(load)->setMetadata(
+      llvm::LLVMContext::MD_invariant_load,
+      llvm::MDNode::get(gIR->context(), llvm::None));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 LLValue *DtoBitCast(LLValue *v, LLType *t, const llvm::Twine &name) {
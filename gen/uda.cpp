@@ -1,5 +1,6 @@
 #include "gen/uda.h"
 
+#include "gen/irstate.h"
 #include "gen/llvm.h"
 #include "gen/llvmhelpers.h"
 #include "aggregate.h"
@@ -20,6 +21,7 @@ const std::string llvmFastMathFlag = "llvmFastMathFlag";
 const std::string optStrategy = "optStrategy";
 const std::string section = "section";
 const std::string target = "target";
+const std::string targetClones = "target_clones";
 const std::string weak = "_weak";
 }
 
@@ -178,15 +180,49 @@ void applyAttrSection(StructLiteralExp *sle, llvm::GlobalObject *globj) {
 }
 
 void applyAttrTarget(StructLiteralExp *sle, llvm::Function *func) {
+  checkStructElems(sle, {Type::tstring});
+  applyTargetSpec(getFirstElemString(sle), func);
+}
+
+// @target_clones("default", "avx2", ...)
+void applyAttrTargetClones(StructLiteralExp *sle, IrFunction *irFunc) {
+  checkStructElems(sle, {Type::tstring->arrayOf()});
+
+  TargetClones clones;
+  clones.decl = irFunc->decl;
+  clones.func = irFunc->func;
+
+  auto arg = (*sle->elements)[0];
+  if (arg && arg->op == TOKarrayliteral) {
+    auto ale = static_cast<ArrayLiteralExp *>(arg);
+    for (auto elem : *ale->elements) {
+      if (!elem) {
+        elem = ale->basis;
+      }
+      if (elem && elem->op == TOKstring) {
+        clones.specs.push_back(static_cast<StringExp *>(elem)->toStringz());
+      }
+    }
+  }
+
+  if (clones.specs.empty()) {
+    sle->error("'@ldc.attributes.%s' requires at least one target",
+               sle->sd->ident->string);
+    return;
+  }
+
+  gIR->targetClones.push_back(std::move(clones));
+}
+
+} // anonymous namespace
+
+void applyTargetSpec(llvm::StringRef targetspec, llvm::Function *func) {
   // TODO: this is a rudimentary implementation for @target. Many more
   // target-related attributes could be applied to functions (not just for
   // @target): clang applies many attributes that LDC does not.
   // The current implementation here does not do any checking of the specified
   // string and simply passes all to llvm.
 
-  checkStructElems(sle, {Type::tstring});
-  std::string targetspec = getFirstElemString(sle);
-
   if (targetspec.empty() || targetspec == "default")
     return;
 
@@ -242,8 +278,6 @@ void applyAttrTarget(StructLiteralExp *sle, llvm::Function *func) {
   }
 }
 
-} // anonymous namespace
-
 void applyVarDeclUDAs(VarDeclaration *decl, llvm::GlobalVariable *gvar) {
   if (!decl->userAttribDecl)
     return;
@@ -262,9 +296,10 @@ void applyVarDeclUDAs(VarDeclaration *decl, llvm::GlobalVariable *gvar) {
       sle->error(
           "Special attribute 'ldc.attributes.optStrategy' is only valid for "
           "functions");
-    } else if (name == attr::target) {
-      sle->error("Special attribute 'ldc.attributes.target' is only valid for "
-                 "functions");
+    } else if (name == attr::target || name == attr::targetClones) {
+      sle->error("Special attribute 'ldc.attributes.%s' is only valid for "
+                 "functions",
+                 sle->sd->ident->string);
     } else if (name == attr::weak) {
       // @weak is applied elsewhere
     } else {
@@ -300,6 +335,8 @@ void applyFuncDeclUDAs(FuncDeclaration *decl, IrFunction *irFunc) {
       applyAttrSection(sle, func);
     } else if (name == attr::target) {
       applyAttrTarget(sle, func);
+    } else if (name == attr::targetClones) {
+      applyAttrTargetClones(sle, irFunc);
     } else if (name == attr::weak) {
       // @weak is applied elsewhere
     } else {
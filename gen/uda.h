@@ -20,7 +20,9 @@ class FuncDeclaration;
 class VarDeclaration;
 struct IrFunction;
 namespace llvm {
+class Function;
 class GlobalVariable;
+class StringRef;
 }
 
 void applyFuncDeclUDAs(FuncDeclaration *decl, IrFunction *irFunc);
@@ -28,4 +30,8 @@ void applyVarDeclUDAs(VarDeclaration *decl, llvm::GlobalVariable *gvar);
 
 bool hasWeakUDA(Dsymbol *sym);
 
+/// Applies a @target specification such as "arch=haswell,avx2,no-sse4a" to
+/// the given function.
+void applyTargetSpec(llvm::StringRef targetspec, llvm::Function *func);
+
 #endif
@@ -17,6 +17,7 @@
 #include "gen/llvmhelpers.h"
 #include "gen/logger.h"
 #include "gen/mangling.h"
+#include "gen/optimizer.h"
 #include "gen/tollvm.h"
 #include "ir/iraggr.h"
 #include "irdsymbol.h"
@@ -34,6 +35,17 @@ IrAggr::IrAggr(AggregateDeclaration *aggr)
 
 //////////////////////////////////////////////////////////////////////////////
 
+/// Returns whether the instances of `ad` contain pointers to interface
+/// vtables, which are defined by the module declaring the class.
+static bool hasInterfaceVtbls(AggregateDeclaration *ad) {
+  for (auto cd = ad->isClassDeclaration(); cd; cd = cd->baseClass) {
+    if (cd->vtblInterfaces && cd->vtblInterfaces->dim > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 LLGlobalVariable *IrAggr::getInitSymbol() {
   if (init) {
     return init;
@@ -49,6 +61,19 @@ LLGlobalVariable *IrAggr::getInitSymbol() {
   // set alignment
   init->setAlignment(DtoAlignment(type));
 
+  // Until defined by the aggregate's codegen (which then also sets the
+  // linkage), expose the initializer as available_externally. This enables
+  // the optimizer to fold default-initializations copying from the symbol to
+  // constant stores, for aggregates defined in other modules too. Building
+  // the initializer of a class implementing interfaces would define the
+  // interface vtables in this module, so such classes are skipped.
+  if (isOptimizationEnabled() && !init->hasInitializer() &&
+      aggrdecl->sizeok == SIZEOKdone && aggrdecl->type->ty != Terror &&
+      !hasInterfaceVtbls(aggrdecl)) {
+    init->setInitializer(getDefaultInit());
+    init->setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+  }
+
   return init;
 }
 
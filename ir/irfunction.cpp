@@ -287,7 +287,7 @@ llvm::BasicBlock *ScopeStack::runCleanupPad(CleanupCursor scope,
   auto savedInsertPoint = irs->ir->GetInsertPoint();
   auto savedDbgLoc = irs->DBuilder.GetCurrentLoc();
 
-  auto endFn = getRuntimeFunction(Loc(), irs->module, "_d_leave_cleanup");
+  auto endFn = getRuntimeFunction(Loc(), irs->module, RTFunc::_d_leave_cleanup);
   irs->ir->SetInsertPoint(cleanupret);
   irs->DBuilder.EmitStopPoint(irs->func()->decl->loc);
   irs->ir->CreateCall(endFn, frame,
@@ -297,7 +297,8 @@ llvm::BasicBlock *ScopeStack::runCleanupPad(CleanupCursor scope,
   auto copybb = executeCleanupCopying(irs, cleanupScopes[scope], cleanupbb,
                                       cleanupret, unwindTo, cleanuppad);
 
-  auto beginFn = getRuntimeFunction(Loc(), irs->module, "_d_enter_cleanup");
+  auto beginFn =
+      getRuntimeFunction(Loc(), irs->module, RTFunc::_d_enter_cleanup);
   irs->ir->SetInsertPoint(cleanupbb);
   irs->DBuilder.EmitStopPoint(irs->func()->decl->loc);
   auto exec = irs->ir->CreateCall(
@@ -503,13 +504,13 @@ llvm::LandingPadInst *createLandingPadInst(IRState *irs) {
   LLFunction *currentFunction = irs->func()->func;
   if (!currentFunction->hasPersonalityFn()) {
     LLFunction *personalityFn =
-        getRuntimeFunction(Loc(), irs->module, "_d_eh_personality");
+        getRuntimeFunction(Loc(), irs->module, RTFunc::_d_eh_personality);
     currentFunction->setPersonalityFn(personalityFn);
   }
   return irs->ir->CreateLandingPad(retType, 0);
 #else
   LLFunction *personalityFn =
-      getRuntimeFunction(Loc(), irs->module, "_d_eh_personality");
+      getRuntimeFunction(Loc(), irs->module, RTFunc::_d_eh_personality);
   return irs->ir->CreateLandingPad(retType, personalityFn, 0);
 #endif
 }
@@ -520,9 +521,8 @@ llvm::BasicBlock *ScopeStack::emitLandingPadMSVCEH(CleanupCursor scope) {
 
   LLFunction *currentFunction = irs->func()->func;
   if (!currentFunction->hasPersonalityFn()) {
-    const char *personality = "__CxxFrameHandler3";
     LLFunction *personalityFn =
-        getRuntimeFunction(Loc(), irs->module, personality);
+        getRuntimeFunction(Loc(), irs->module, RTFunc::__CxxFrameHandler3);
     currentFunction->setPersonalityFn(personalityFn);
   }
 
@@ -658,7 +658,7 @@ llvm::BasicBlock *IrFunction::getOrCreateResumeUnwindBlock() {
     gIR->scope() = IRScope(resumeUnwindBlock);
 
     llvm::Function *resumeFn =
-        getRuntimeFunction(Loc(), gIR->module, "_d_eh_resume_unwind");
+        getRuntimeFunction(Loc(), gIR->module, RTFunc::_d_eh_resume_unwind);
     gIR->ir->CreateCall(resumeFn, DtoLoad(getOrCreateEhPtrSlot()));
     gIR->ir->CreateUnreachable();
 
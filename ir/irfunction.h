@@ -302,9 +302,13 @@ public:
 
   /// Emits a call or invoke to the given callee, depending on whether there
   /// are catches/cleanups active or not.
+  ///
+  /// A plain call is also emitted for callees which can't throw, i.e.,
+  /// intrinsics, nounwind functions and callees of (possibly inferred)
+  /// nothrow D function type, as specified by isNothrow.
   template <typename T>
   llvm::CallSite callOrInvoke(llvm::Value *callee, const T &args,
-                              const char *name = "");
+                              const char *name = "", bool isNothrow = false);
 
   /// Terminates the current basic block with an unconditional branch to the
   /// given label, along with the cleanups to execute on the way there.
@@ -405,14 +409,18 @@ private:
 
 template <typename T>
 llvm::CallSite ScopeStack::callOrInvoke(llvm::Value *callee, const T &args,
-                                        const char *name) {
+                                        const char *name, bool isNothrow) {
   // If this is a direct call, we might be able to use the callee attributes
   // to our advantage.
   llvm::Function *calleeFn = llvm::dyn_cast<llvm::Function>(callee);
 
   // Intrinsics don't support invoking and 'nounwind' functions don't need it.
+  // Also look through bitcasts, e.g., of runtime functions declared with a
+  // different signature.
+  auto targetFn = llvm::dyn_cast<llvm::Function>(callee->stripPointerCasts());
   const bool doesNotThrow =
-      calleeFn && (calleeFn->isIntrinsic() || calleeFn->doesNotThrow());
+      isNothrow ||
+      (targetFn && (targetFn->isIntrinsic() || targetFn->doesNotThrow()));
 
 #if LDC_LLVM_VER >= 308
   // calls inside a funclet must be annotated with its value
@@ -430,6 +438,9 @@ llvm::CallSite ScopeStack::callOrInvoke(llvm::Value *callee, const T &args,
     if (calleeFn) {
       call->setAttributes(calleeFn->getAttributes());
     }
+    if (isNothrow) {
+      call->setDoesNotThrow();
+    }
     return call;
   }
 
@@ -130,5 +130,7 @@ AttrSet IrFuncTy::getParamAttrs(bool passThisBeforeSret) {
     newAttrs.add(i, args[k]->attrs);
   }
 
+  newAttrs.add(llvm::AttributeSet::FunctionIndex, fnAttrs);
+
   return newAttrs;
 }
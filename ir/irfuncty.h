@@ -110,6 +110,9 @@ struct IrFuncTy {
   // reserved for ABI-specific data
   void *tag = nullptr;
 
+  // function attributes derived from the D function type (nothrow, pure)
+  AttrBuilder fnAttrs;
+
   llvm::Value *putRet(DValue *dval);
   llvm::Value *getRetRVal(Type *dty, llvm::Value *val);
   llvm::Value *getRetLVal(Type *dty, llvm::Value *val);
@@ -164,6 +164,7 @@ void AggrTypeBuilder::addAggregate(AggregateDeclaration *ad) {
     // §7.1.1.
     if (m_offset < vd->offset) {
       m_fieldIndex += add_zeros(m_defaultTypes, m_offset, vd->offset);
+      m_paddingSize += vd->offset - m_offset;
       m_offset = vd->offset;
     }
 
@@ -185,6 +186,7 @@ void AggrTypeBuilder::alignCurrentOffset(unsigned alignment) {
   unsigned aligned = (m_offset + alignment - 1) & ~(alignment - 1);
   if (m_offset < aligned) {
     m_fieldIndex += add_zeros(m_defaultTypes, m_offset, aligned);
+    m_paddingSize += aligned - m_offset;
     m_offset = aligned;
   }
 }
@@ -193,6 +195,7 @@ void AggrTypeBuilder::addTailPadding(unsigned aggregateSize) {
   // tail padding?
   if (m_offset < aggregateSize) {
     add_zeros(m_defaultTypes, m_offset, aggregateSize);
+    m_paddingSize += aggregateSize - m_offset;
   }
 }
 
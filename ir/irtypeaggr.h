@@ -37,6 +37,8 @@ public:
   std::vector<llvm::Type *> defaultTypes() const { return m_defaultTypes; }
   VarGEPIndices varGEPIndices() const { return m_varGEPIndices; }
   unsigned overallAlignment() const { return m_overallAlignment; }
+  /// The number of padding bytes added so far.
+  unsigned paddingSize() const { return m_paddingSize; }
 
 protected:
   std::vector<llvm::Type *> m_defaultTypes;
@@ -44,6 +46,7 @@ protected:
   unsigned m_offset = 0;
   unsigned m_fieldIndex = 0;
   unsigned m_overallAlignment = 0;
+  unsigned m_paddingSize = 0;
   bool m_packed = false;
 };
 
@@ -17,6 +17,7 @@
 #include "template.h"
 
 #include "gen/irstate.h"
+#include "gen/layoutreport.h"
 #include "gen/logger.h"
 #include "gen/tollvm.h"
 #include "gen/llvmhelpers.h"
@@ -116,6 +117,7 @@ IrTypeClass *IrTypeClass::get(ClassDeclaration *cd) {
   // set struct body and copy GEP indices
   isaStruct(t->type)->setBody(builder.defaultTypes(), t->packed);
   t->varGEPIndices = builder.varGEPIndices();
+  addAggregateLayout(cd, builder.paddingSize());
 
   // set vtbl type body
   FuncDeclarations vtbl;
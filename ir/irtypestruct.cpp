@@ -17,6 +17,7 @@
 #include "mtype.h"
 
 #include "gen/irstate.h"
+#include "gen/layoutreport.h"
 #include "gen/tollvm.h"
 #include "gen/logger.h"
 #include "gen/llvmhelpers.h"
@@ -54,6 +55,7 @@ IrTypeStruct *IrTypeStruct::get(StructDeclaration *sd) {
   builder.addTailPadding(sd->structsize);
   isaStruct(t->type)->setBody(builder.defaultTypes(), t->packed);
   t->varGEPIndices = builder.varGEPIndices();
+  addAggregateLayout(sd, builder.paddingSize());
 
   IF_LOG Logger::cout() << "final struct type: " << *t->type << std::endl;
 
@@ -11,6 +11,9 @@ extern "C" {
 
 #include "InstrProfiling.h"
 
+/* LDC: see InstrProfilingPeriodic.c */
+COMPILER_RT_VISIBILITY void __ldc_profile_initialize_periodic_dump(void);
+
 COMPILER_RT_VISIBILITY int __llvm_profile_runtime;
 }
 
@@ -21,6 +24,7 @@ public:
   RegisterRuntime() {
     __llvm_profile_register_write_file_atexit();
     __llvm_profile_initialize_file();
+    __ldc_profile_initialize_periodic_dump();
   }
 };
 
@@ -0,0 +1,159 @@
+/*===- InstrProfilingPeriodic.c - Periodic dumping of profile data --------===*\
+|*
+|*                         LDC – the LLVM D compiler
+|*
+|* This file is distributed under the BSD-style LDC license. See the LICENSE
+|* file for details.
+|*
+|* Not part of upstream compiler-rt. Lets long-running processes (that may
+|* never exit cleanly) write their profile data in windows: the counters are
+|* written to the current profile file (honoring the %p/%h/%m specifiers of
+|* the filename pattern) and then reset, so that consecutive windows can be
+|* summed by llvm-profdata without counting anything twice.
+|* With %m in the filename pattern, each dump is merged into the existing raw
+|* profile on disk under file locking (see openFileForMerging()), so that
+|* many processes of the same binary can share one profile file.
+|*
+\*===----------------------------------------------------------------------===*/
+
+#include "InstrProfiling.h"
+#include "InstrProfilingInternal.h"
+#include <stdlib.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/* Interval between two dumps in seconds; 0 stops the dump thread. */
+static volatile unsigned DumpInterval = 0;
+static volatile int DumpThreadRunning = 0;
+
+#if defined(_WIN32)
+static SRWLOCK DumpLock = SRWLOCK_INIT;
+static void lockDump(void) { AcquireSRWLockExclusive(&DumpLock); }
+static void unlockDump(void) { ReleaseSRWLockExclusive(&DumpLock); }
+static void sleepSeconds(unsigned Seconds) { Sleep(Seconds * 1000); }
+#else
+static pthread_mutex_t DumpLock = PTHREAD_MUTEX_INITIALIZER;
+static void lockDump(void) { pthread_mutex_lock(&DumpLock); }
+static void unlockDump(void) { pthread_mutex_unlock(&DumpLock); }
+static void sleepSeconds(unsigned Seconds) { sleep(Seconds); }
+#endif
+
+/* Writes the profile data to the current profile file and resets the
+ * counters if that succeeded. Returns 0 on success.
+ * Resetting is required for correctness, not just convenience: when merging
+ * (%m), the file contents are merged into the in-memory counters before
+ * writing, and without merging, the data is appended to the file. Either way
+ * the next dump must only contain the counts of the new window. */
+COMPILER_RT_VISIBILITY
+int __ldc_profile_dump_and_reset(void) {
+  int rc;
+  lockDump();
+  rc = __llvm_profile_write_file();
+  if (!rc)
+    __llvm_profile_reset_counters();
+  unlockDump();
+  return rc;
+}
+
+/* Waits for an in-flight dump to finish and keeps the dump thread from
+ * starting another one, before the atexit handler of profile-rt writes the
+ * final window. atexit handlers run in reverse order of registration, and
+ * this one is always registered after __llvm_profile_register_write_file_atexit
+ * has been called. */
+static void stopDumpingAtExit(void) {
+  DumpInterval = 0;
+  lockDump();
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI dumpThread(LPVOID Arg) {
+#else
+static void *dumpThread(void *Arg) {
+#endif
+  unsigned Interval;
+  (void)Arg;
+  while ((Interval = DumpInterval) != 0) {
+    sleepSeconds(Interval);
+    if (DumpInterval == 0)
+      break;
+    __ldc_profile_dump_and_reset();
+  }
+  DumpThreadRunning = 0;
+  return 0;
+}
+
+/* Starts a background thread that calls __ldc_profile_dump_and_reset() every
+ * \p Seconds seconds. If the thread is already running, only the interval is
+ * changed (taking effect after the current sleep). Returns 0 on success. */
+COMPILER_RT_VISIBILITY
+int __ldc_profile_start_periodic_dump(unsigned Seconds) {
+  static int AtExitRegistered = 0;
+
+  if (Seconds == 0)
+    return -1;
+  DumpInterval = Seconds;
+  if (DumpThreadRunning)
+    return 0;
+
+  if (!AtExitRegistered) {
+    __llvm_profile_register_write_file_atexit();
+    if (atexit(stopDumpingAtExit))
+      return -1;
+    AtExitRegistered = 1;
+  }
+
+  DumpThreadRunning = 1;
+#if defined(_WIN32)
+  {
+    HANDLE Thread = CreateThread(NULL, 0, dumpThread, NULL, 0, NULL);
+    if (!Thread) {
+      DumpThreadRunning = 0;
+      PROF_ERR("Failed to start periodic profile dumping: %s\n",
+               "cannot create thread");
+      return -1;
+    }
+    CloseHandle(Thread);
+  }
+#else
+  {
+    pthread_t Thread;
+    if (pthread_create(&Thread, NULL, dumpThread, NULL)) {
+      DumpThreadRunning = 0;
+      PROF_ERR("Failed to start periodic profile dumping: %s\n",
+               "cannot create thread");
+      return -1;
+    }
+    pthread_detach(Thread);
+  }
+#endif
+  return 0;
+}
+
+/* Stops the periodic dump thread (after its current sleep). The counts of the
+ * current window are still written at exit, or by an explicit call to
+ * __ldc_profile_dump_and_reset(). */
+COMPILER_RT_VISIBILITY
+void __ldc_profile_stop_periodic_dump(void) { DumpInterval = 0; }
+
+/* Starts periodic dumping if the LDC_PROFILE_DUMP_INTERVAL environment
+ * variable is set to a positive number of seconds. Called on startup, after
+ * the profile filename has been initialized. */
+COMPILER_RT_VISIBILITY
+void __ldc_profile_initialize_periodic_dump(void) {
+  const char *IntervalStr = getenv("LDC_PROFILE_DUMP_INTERVAL");
+  int Interval;
+  if (!IntervalStr || !IntervalStr[0])
+    return;
+  Interval = atoi(IntervalStr);
+  if (Interval <= 0) {
+    PROF_WARN("Invalid LDC_PROFILE_DUMP_INTERVAL '%s', expected a positive "
+              "number of seconds.\n",
+              IntervalStr);
+    return;
+  }
+  __ldc_profile_start_periodic_dump((unsigned)Interval);
+}
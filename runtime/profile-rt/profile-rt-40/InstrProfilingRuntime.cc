@@ -11,6 +11,9 @@ extern "C" {
 
 #include "InstrProfiling.h"
 
+/* LDC: see InstrProfilingPeriodic.c */
+COMPILER_RT_VISIBILITY void __ldc_profile_initialize_periodic_dump(void);
+
 /* int __llvm_profile_runtime  */
 COMPILER_RT_VISIBILITY int INSTR_PROF_PROFILE_RUNTIME_VAR;
 }
@@ -22,6 +25,7 @@ public:
   RegisterRuntime() {
     __llvm_profile_register_write_file_atexit();
     __llvm_profile_initialize_file();
+    __ldc_profile_initialize_periodic_dump();
   }
 };
 